@@ -0,0 +1,14 @@
+TEMPLATE = subdirs
+# Startup of the Qt Quick example with the QML files compiled ahead of time
+# (aot) and compiled by the engine on launch (jit).
+qtHaveModule(quick): SUBDIRS += startup/aot startup/jit
+# Time to first frame of 50 windows restored from a saved state.
+!win32: SUBDIRS += restore
+# Button press to the first ConfigureNotify of a move, over xcb directly and
+# through QWindow (xcb with a window manager, e.g. Xvfb and openbox).
+unix:!macx:packagesExist(xcb-xtest): SUBDIRS += moveresize
+# Eager against lazy resolution of the xcb functions.
+unix:!macx: SUBDIRS += resolver
+# Throughput and Win32 calls per message of WinNativeEventFilter, on a fake of
+# the Win32 API (every platform).
+SUBDIRS += winmessages
@@ -0,0 +1,204 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// Latency from the button press to the first ConfigureNotify of a window
+// move, started by sending _NET_WM_MOVERESIZE over xcb directly
+// (X11NativeEventFilter) and by QWindow::startSystemMove(). The press and the
+// motion are faked with XTest, so the window manager sees a real pointer
+// grab. Needs the xcb platform and a window manager that supports
+// _NET_WM_MOVERESIZE, e.g. run it under Xvfb with openbox, KWin or Mutter.
+
+#include "x11nativeeventfilter.h"
+#include <QAbstractNativeEventFilter>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QMouseEvent>
+#include <QRasterWindow>
+#include <QTimer>
+#include <QtTest>
+#include <algorithm>
+#include <qpa/qplatformnativeinterface.h>
+#include <xcb/xcb.h>
+#include <xcb/xtest.h>
+
+namespace {
+
+const int m_iterations = 20;
+// Give up on a drag after this long.
+const int m_timeout = 2000;
+// How often the pointer is moved while waiting for the window manager.
+const int m_motionInterval = 1;
+
+enum class Path { Direct, Qt };
+
+xcb_connection_t *getConnection() {
+    return static_cast<xcb_connection_t *>(
+        QGuiApplication::platformNativeInterface()
+            ->nativeResourceForIntegration(QByteArrayLiteral("connection")));
+}
+
+xcb_window_t getRootWindow() {
+    return static_cast<xcb_window_t>(reinterpret_cast<quintptr>(
+        QGuiApplication::platformNativeInterface()
+            ->nativeResourceForIntegration(QByteArrayLiteral("rootwindow"))));
+}
+
+void fakeInput(const quint8 type, const quint8 detail, const QPoint &pos) {
+    xcb_connection_t *const connection = getConnection();
+    xcb_test_fake_input(connection, type, detail, XCB_CURRENT_TIME,
+                        getRootWindow(), pos.x(), pos.y(), XCB_NONE);
+    xcb_flush(connection);
+}
+
+// Starts the move on the press and stops the clock on the first
+// ConfigureNotify of the window.
+class DragWindow : public QRasterWindow, public QAbstractNativeEventFilter {
+public:
+    Path path = Path::Direct;
+    bool started = false, configured = false;
+    QElapsedTimer timer = {};
+    qint64 latency = -1;
+
+    bool nativeEventFilter(const QByteArray &eventType, void *message,
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+                           qintptr *result
+#else
+                           long *result
+#endif
+                           ) override {
+        Q_UNUSED(result)
+        if (configured || !started ||
+            (eventType != QByteArrayLiteral("xcb_generic_event_t"))) {
+            return false;
+        }
+        const auto event = static_cast<xcb_generic_event_t *>(message);
+        if ((event->response_type & ~0x80) == XCB_CONFIGURE_NOTIFY) {
+            const auto notify =
+                static_cast<xcb_configure_notify_event_t *>(message);
+            if (notify->window == static_cast<xcb_window_t>(winId())) {
+                configured = true;
+                latency = timer.nsecsElapsed();
+            }
+        }
+        return false;
+    }
+
+protected:
+    void mousePressEvent(QMouseEvent *event) override {
+        if (event->button() != Qt::LeftButton) {
+            return;
+        }
+        started = (path == Path::Direct)
+            ? X11NativeEventFilter::startSystemMoveResize(
+                  this, event->globalPos(), {})
+            : startSystemMove();
+    }
+};
+
+} // namespace
+
+class MoveResizeBenchmark : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void latency_data();
+    void latency();
+
+private:
+    qint64 drag(DragWindow *const window, const Path path) const;
+};
+
+void MoveResizeBenchmark::initTestCase() {
+    if (!X11NativeEventFilter::isAvailable()) {
+        QSKIP("Needs X11 and a window manager that supports "
+              "_NET_WM_MOVERESIZE.");
+    }
+}
+
+void MoveResizeBenchmark::latency_data() {
+    QTest::addColumn<int>("path");
+    QTest::newRow("xcb") << static_cast<int>(Path::Direct);
+    QTest::newRow("QWindow") << static_cast<int>(Path::Qt);
+}
+
+void MoveResizeBenchmark::latency() {
+    QFETCH(int, path);
+    DragWindow window;
+    window.setFlags(Qt::Window | Qt::FramelessWindowHint);
+    window.setGeometry(100, 100, 300, 200);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    qApp->installNativeEventFilter(&window);
+    QVector<qint64> latencies = {};
+    for (int i = 0; i != m_iterations; ++i) {
+        const qint64 latency = drag(&window, static_cast<Path>(path));
+        if (latency < 0) {
+            qApp->removeNativeEventFilter(&window);
+            QFAIL("The window manager didn't move the window.");
+        }
+        latencies.append(latency);
+    }
+    qApp->removeNativeEventFilter(&window);
+    std::sort(latencies.begin(), latencies.end());
+    qInfo("%s: press to first ConfigureNotify: min %.2f ms, median %.2f ms, "
+          "max %.2f ms",
+          QTest::currentDataTag(), latencies.first() / 1000000.0,
+          latencies.at(latencies.size() / 2) / 1000000.0,
+          latencies.last() / 1000000.0);
+}
+
+qint64 MoveResizeBenchmark::drag(DragWindow *const window,
+                                 const Path path) const {
+    window->path = path;
+    window->started = false;
+    window->configured = false;
+    window->latency = -1;
+    window->setPosition(100, 100);
+    QTest::qWait(100);
+    QPoint pos = window->mapToGlobal(QPoint(150, 15));
+    fakeInput(XCB_MOTION_NOTIFY, 0, pos);
+    QTest::qWait(50);
+    window->timer.start();
+    fakeInput(XCB_BUTTON_PRESS, XCB_BUTTON_INDEX_1, pos);
+    // Keep the pointer moving, the window manager only moves the window once
+    // it has grabbed the pointer and seen a motion.
+    QTimer motion;
+    motion.setInterval(m_motionInterval);
+    QObject::connect(&motion, &QTimer::timeout, [&pos]() {
+        pos += QPoint(1, 1);
+        fakeInput(XCB_MOTION_NOTIFY, 0, pos);
+    });
+    motion.start();
+    QTest::qWaitFor([window]() { return window->configured; }, m_timeout);
+    motion.stop();
+    fakeInput(XCB_BUTTON_RELEASE, XCB_BUTTON_INDEX_1, pos);
+    QTest::qWait(100);
+    return window->configured ? window->latency : -1;
+}
+
+QTEST_MAIN(MoveResizeBenchmark)
+
+#include "moveresize.moc"
@@ -0,0 +1,7 @@
+TARGET = moveresize
+TEMPLATE = app
+include(../bench.pri)
+# XTest fakes the button press and the motion the window manager reacts to.
+CONFIG += link_pkgconfig
+PKGCONFIG += xcb xcb-xtest
+SOURCES += moveresize.cpp
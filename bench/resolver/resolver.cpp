@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// Eager against lazy resolution of the functions of the X11 backend. The
+// eager variant is what the backend did before SymbolResolver: load the
+// libraries and resolve every function up front. The lazy variant resolves
+// only what the first button press needs (the rest is never resolved in most
+// sessions, and nothing at all on Wayland). The call benchmarks show what a
+// LazySymbol costs per call once it's resolved, against a plain function
+// pointer.
+
+#include "symbolresolver.h"
+#include <QLibrary>
+#include <QtTest>
+#include <cmath>
+
+namespace {
+
+const char *const m_xcbSymbols[] = {"xcb_change_property",
+                                    "xcb_flush",
+                                    "xcb_get_property",
+                                    "xcb_get_property_reply",
+                                    "xcb_get_property_value",
+                                    "xcb_get_property_value_length",
+                                    "xcb_intern_atom",
+                                    "xcb_intern_atom_reply",
+                                    "xcb_query_extension",
+                                    "xcb_query_extension_reply",
+                                    "xcb_send_event",
+                                    "xcb_ungrab_pointer"};
+const char *const m_xcbShapeSymbols[] = {"xcb_shape_mask",
+                                         "xcb_shape_rectangles"};
+
+const int m_calls = 10000;
+
+using MathFunction = double (*)(double);
+
+} // namespace
+
+class ResolverBenchmark : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void eagerStartup();
+    void lazyStartup();
+    void callFunctionPointer();
+    void callLazySymbol();
+};
+
+void ResolverBenchmark::initTestCase() {
+    if (!SymbolResolver::resolve(QStringLiteral("xcb"), 1, "xcb_flush")) {
+        QSKIP("libxcb.so.1 is not available.");
+    }
+}
+
+void ResolverBenchmark::eagerStartup() {
+    QBENCHMARK {
+        QLibrary xcb(QStringLiteral("xcb"), 1);
+        for (auto &&symbol : m_xcbSymbols) {
+            QVERIFY(xcb.resolve(symbol));
+        }
+        QLibrary xcbShape(QStringLiteral("xcb-shape"), 0);
+        for (auto &&symbol : m_xcbShapeSymbols) {
+            xcbShape.resolve(symbol);
+        }
+    }
+}
+
+void ResolverBenchmark::lazyStartup() {
+    QBENCHMARK {
+        // Declared like FLH_GENERATE_SYMBOL does, only the two functions the
+        // first _NET_WM_MOVERESIZE needs are ever resolved.
+        const LazySymbol<void()> lpxcb_send_event("xcb", 1, "xcb_send_event");
+        const LazySymbol<void()> lpxcb_flush("xcb", 1, "xcb_flush");
+        QVERIFY(lpxcb_send_event.isAvailable());
+        QVERIFY(lpxcb_flush.isAvailable());
+    }
+}
+
+void ResolverBenchmark::callFunctionPointer() {
+    volatile MathFunction function = &std::cos;
+    double sum = 0.0;
+    QBENCHMARK {
+        for (int i = 0; i != m_calls; ++i) {
+            sum += function(i);
+        }
+    }
+    QVERIFY(!std::isnan(sum));
+}
+
+void ResolverBenchmark::callLazySymbol() {
+    const LazySymbol<double(double)> lpcos("m", 6, "cos");
+    if (!lpcos.isAvailable()) {
+        QSKIP("libm.so.6 is not available.");
+    }
+    double sum = 0.0;
+    QBENCHMARK {
+        for (int i = 0; i != m_calls; ++i) {
+            sum += lpcos(i);
+        }
+    }
+    QVERIFY(!std::isnan(sum));
+}
+
+QTEST_MAIN(ResolverBenchmark)
+
+#include "resolver.moc"
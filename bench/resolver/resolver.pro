@@ -0,0 +1,4 @@
+TARGET = resolver
+TEMPLATE = app
+include(../bench.pri)
+SOURCES += resolver.cpp
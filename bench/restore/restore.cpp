@@ -0,0 +1,153 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// Time to first frame of 50 windows whose geometry was saved by the previous
+// session: restoreWindowState() before show() against the usual resize,
+// center, show, setGeometry sequence with the geometry read from QSettings.
+
+#include "framelesshelper.h"
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QRasterWindow>
+#include <QResizeEvent>
+#include <QScreen>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace {
+
+const int m_windowCount = 50;
+
+QString getWindowKey(const int index) {
+    return QString::fromUtf8("window%1").arg(index);
+}
+
+// Counts the geometry changes the window goes through after it's shown.
+class BenchWindow : public QRasterWindow {
+public:
+    int moves = 0, resizes = 0;
+
+protected:
+    void moveEvent(QMoveEvent *event) override {
+        if (isExposed()) {
+            ++moves;
+        }
+        QRasterWindow::moveEvent(event);
+    }
+    void resizeEvent(QResizeEvent *event) override {
+        if (isExposed()) {
+            ++resizes;
+        }
+        QRasterWindow::resizeEvent(event);
+    }
+};
+
+} // namespace
+
+class RestoreBenchmark : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void legacySequence();
+    void restoreWindowState();
+
+private:
+    void showAndWait(const QVector<BenchWindow *> &windows,
+                     const char *name) const;
+
+    QTemporaryDir m_dir = {};
+    QString m_stateFile = {}, m_settingsFile = {};
+};
+
+void RestoreBenchmark::initTestCase() {
+    QVERIFY(m_dir.isValid());
+    m_stateFile = m_dir.filePath(QString::fromUtf8("windows.state"));
+    m_settingsFile = m_dir.filePath(QString::fromUtf8("windows.ini"));
+    const QRect available =
+        QGuiApplication::primaryScreen()->availableGeometry();
+    QSettings settings(m_settingsFile, QSettings::IniFormat);
+    for (int i = 0; i != m_windowCount; ++i) {
+        // Cascade the windows over the available area of the screen.
+        const QRect geometry = {available.x() + ((i * 13) % 200),
+                                available.y() + ((i * 17) % 150), 400, 300};
+        QWindow window;
+        window.setGeometry(geometry);
+        QVERIFY(FramelessHelper::saveWindowState(&window, getWindowKey(i),
+                                                 m_stateFile));
+        settings.setValue(getWindowKey(i), geometry);
+    }
+}
+
+void RestoreBenchmark::legacySequence() {
+    QVector<BenchWindow *> windows = {};
+    QBENCHMARK_ONCE {
+        const QSettings settings(m_settingsFile, QSettings::IniFormat);
+        for (int i = 0; i != m_windowCount; ++i) {
+            const auto window = new BenchWindow;
+            const QRect geometry = settings.value(getWindowKey(i)).toRect();
+            window->resize(geometry.size());
+            FramelessHelper::moveWindowToDesktopCenter(window);
+            window->show();
+            window->setGeometry(geometry);
+            windows.append(window);
+        }
+        showAndWait(windows, "legacy");
+    }
+    qDeleteAll(windows);
+}
+
+void RestoreBenchmark::restoreWindowState() {
+    QVector<BenchWindow *> windows = {};
+    QBENCHMARK_ONCE {
+        for (int i = 0; i != m_windowCount; ++i) {
+            const auto window = new BenchWindow;
+            QVERIFY(FramelessHelper::restoreWindowState(
+                window, getWindowKey(i), m_stateFile));
+            window->show();
+            windows.append(window);
+        }
+        showAndWait(windows, "restoreWindowState");
+    }
+    qDeleteAll(windows);
+}
+
+void RestoreBenchmark::showAndWait(const QVector<BenchWindow *> &windows,
+                                   const char *name) const {
+    for (auto &&window : qAsConst(windows)) {
+        QVERIFY(QTest::qWaitForWindowExposed(window));
+    }
+    int moves = 0, resizes = 0;
+    for (auto &&window : qAsConst(windows)) {
+        moves += window->moves;
+        resizes += window->resizes;
+    }
+    qInfo("%s: %d moves and %d resizes after show", name, moves, resizes);
+}
+
+QTEST_MAIN(RestoreBenchmark)
+
+#include "restore.moc"
@@ -0,0 +1,4 @@
+TARGET = restore
+TEMPLATE = app
+include(../bench.pri)
+SOURCES += restore.cpp
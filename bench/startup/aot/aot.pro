@@ -0,0 +1,3 @@
+TARGET = startup_aot
+CONFIG += qtquickcompiler
+include(../startup.pri)
@@ -0,0 +1,2 @@
+TARGET = startup_jit
+include(../startup.pri)
@@ -0,0 +1,80 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// Measures the time from entering main() to the first frame of the Qt Quick
+// example. Built twice: "startup_aot" with the QML files compiled ahead of
+// time by qmlcachegen and "startup_jit" with the files compiled by the engine
+// on launch. Run each binary a few times and compare the medians, the disk
+// cache of the engine ($XDG_CACHE_HOME/<app>/qmlcache) should be cleared
+// before the jit runs, otherwise it hides the compile step.
+
+#include "framelessbuttonicons.h"
+#include "framelessquickhelper.h"
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QQmlApplicationEngine>
+#include <QQuickWindow>
+#include <QTextStream>
+
+int main(int argc, char *argv[]) {
+    QElapsedTimer timer;
+    timer.start();
+
+    QGuiApplication application(argc, argv);
+
+    QQmlApplicationEngine engine;
+    qmlRegisterType<FramelessQuickHelper>("wangwenx190.Utils", 1, 0,
+                                          "FramelessHelper");
+    // The engine takes ownership of the image provider.
+    engine.addImageProvider(QString::fromUtf8("framelessbuttons"),
+                            new FramelessButtonImageProvider);
+    const QUrl mainQmlUrl(QString::fromUtf8("qrc:///qml/main.qml"));
+    QObject::connect(
+        &engine, &QQmlApplicationEngine::objectCreated, &application,
+        [&mainQmlUrl, &timer](QObject *object, const QUrl &url) {
+            if (url != mainQmlUrl) {
+                return;
+            }
+            const auto window = qobject_cast<QQuickWindow *>(object);
+            if (!window) {
+                QGuiApplication::exit(-1);
+                return;
+            }
+            QObject::connect(
+                window, &QQuickWindow::frameSwapped, window,
+                [&timer]() {
+                    QTextStream(stdout)
+                        << QCoreApplication::applicationName()
+                        << QString::fromUtf8(": first frame after ")
+                        << timer.elapsed() << QString::fromUtf8(" ms")
+                        << Qt::endl;
+                    QGuiApplication::quit();
+                },
+                Qt::QueuedConnection);
+        });
+    engine.load(mainQmlUrl);
+
+    return QGuiApplication::exec();
+}
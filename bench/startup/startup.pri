@@ -0,0 +1,4 @@
+TEMPLATE = app
+include($$PWD/../bench.pri)
+SOURCES += $$PWD/main.cpp
+RESOURCES += $$PWD/../../resources.qrc
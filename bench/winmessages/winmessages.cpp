@@ -0,0 +1,201 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// Message throughput of WinNativeEventFilter and the Win32 calls it makes per
+// message, on FakeWin32Backend: synthetic messages go through the real
+// filter, the fake counts the calls. The times include the counting and the
+// fake itself, which costs far less than a call into User32 does, so compare
+// them with each other, not with Windows. Runs on every platform.
+
+#include "fakewin32backend.h"
+#include "syntheticmessage.h"
+#include "winnativeeventfilter.h"
+#include <QtTest>
+#include <algorithm>
+
+#ifndef ABE_BOTTOM
+#define ABE_BOTTOM 3
+#endif
+
+namespace {
+
+const int m_messages = 1000;
+
+// In physical pixels, on the primary monitor.
+const QRect m_windowGeometry = {100, 100, 800, 600};
+const QRect m_maximizedGeometry = {-8, -8, 1936, 1096};
+
+RECT toRECT(const QRect &rect) {
+    return {rect.left(), rect.top(), rect.left() + rect.width(),
+            rect.top() + rect.height()};
+}
+
+} // namespace
+
+class WinMessagesBenchmark : public QObject {
+    Q_OBJECT
+
+public:
+    static void initMain() {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void cleanup();
+    void messages_data();
+    void messages();
+
+private:
+    FakeWin32Backend m_backend;
+    QScopedPointer<WinNativeEventFilter> m_filter;
+};
+
+void WinMessagesBenchmark::initTestCase() {
+    // Before the filter resolves the Win32 functions for the first time.
+    Win32Backend::install(&m_backend);
+    m_filter.reset(new WinNativeEventFilter);
+}
+
+void WinMessagesBenchmark::cleanupTestCase() {
+    WinNativeEventFilter::clearFramelessWindows();
+    m_filter.reset();
+}
+
+void WinMessagesBenchmark::cleanup() {
+    WinNativeEventFilter::clearFramelessWindows();
+}
+
+void WinMessagesBenchmark::messages_data() {
+    QTest::addColumn<UINT>("message");
+    QTest::addColumn<bool>("maximized");
+    QTest::addColumn<UINT>("dotsPerInch");
+    QTest::addColumn<bool>("autoHideTaskbar");
+    // Relative to the window, for WM_NCHITTEST.
+    QTest::addColumn<QPoint>("pos");
+    QTest::newRow("WM_NCHITTEST, client area")
+        << UINT(WM_NCHITTEST) << false << 96u << false << QPoint{400, 300};
+    QTest::newRow("WM_NCHITTEST, title bar")
+        << UINT(WM_NCHITTEST) << false << 96u << false << QPoint{400, 20};
+    QTest::newRow("WM_NCHITTEST, corner")
+        << UINT(WM_NCHITTEST) << false << 96u << false << QPoint{2, 2};
+    QTest::newRow("WM_NCHITTEST, 192 dpi")
+        << UINT(WM_NCHITTEST) << false << 192u << false << QPoint{400, 300};
+    QTest::newRow("WM_NCCALCSIZE")
+        << UINT(WM_NCCALCSIZE) << false << 96u << false << QPoint{};
+    QTest::newRow("WM_NCCALCSIZE, maximized")
+        << UINT(WM_NCCALCSIZE) << true << 96u << false << QPoint{};
+    QTest::newRow("WM_NCCALCSIZE, maximized, auto-hide taskbar")
+        << UINT(WM_NCCALCSIZE) << true << 96u << true << QPoint{};
+    QTest::newRow("WM_GETMINMAXINFO")
+        << UINT(WM_GETMINMAXINFO) << false << 96u << false << QPoint{};
+    QTest::newRow("WM_NCACTIVATE")
+        << UINT(WM_NCACTIVATE) << false << 96u << false << QPoint{};
+    QTest::newRow("WM_SETTEXT")
+        << UINT(WM_SETTEXT) << false << 96u << false << QPoint{};
+    // Most messages, the filter only finds out that it doesn't handle them.
+    QTest::newRow("WM_MOUSEMOVE")
+        << UINT(WM_MOUSEMOVE) << false << 96u << false << QPoint{};
+}
+
+void WinMessagesBenchmark::messages() {
+    QFETCH(UINT, message);
+    QFETCH(bool, maximized);
+    QFETCH(UINT, dotsPerInch);
+    QFETCH(bool, autoHideTaskbar);
+    QFETCH(QPoint, pos);
+    m_backend.reset();
+    m_backend.monitor(0)->dotsPerInch = dotsPerInch;
+    if (autoHideTaskbar) {
+        m_backend.setTaskbar(ABE_BOTTOM, true);
+    }
+    const QRect geometry = maximized ? m_maximizedGeometry : m_windowGeometry;
+    const HWND hWnd = m_backend.createWindow(
+        geometry,
+        WS_OVERLAPPEDWINDOW | WS_VISIBLE | (maximized ? WS_MAXIMIZE : 0));
+    WinNativeEventFilter::addFramelessWindow(hWnd);
+    WinNativeEventFilter &filter = *m_filter;
+    const auto sendMessage = [&filter, hWnd, message, geometry, pos]() {
+        NativeEventResult result = 0;
+        switch (message) {
+        case WM_NCCALCSIZE: {
+            NCCALCSIZE_PARAMS params;
+            SecureZeroMemory(&params, sizeof(params));
+            params.rgrc[0] = toRECT(geometry);
+            sendSyntheticMessage(filter, hWnd, message, TRUE,
+                                 reinterpret_cast<LPARAM>(&params), &result);
+        } break;
+        case WM_GETMINMAXINFO: {
+            MINMAXINFO mmi;
+            SecureZeroMemory(&mmi, sizeof(mmi));
+            sendSyntheticMessage(filter, hWnd, message, 0,
+                                 reinterpret_cast<LPARAM>(&mmi), &result);
+        } break;
+        case WM_NCHITTEST:
+            sendSyntheticMessage(
+                filter, hWnd, message, 0,
+                makeScreenPosition(geometry.topLeft() + pos), &result);
+            break;
+        default:
+            sendSyntheticMessage(filter, hWnd, message, TRUE, 0, &result);
+            break;
+        }
+        return result;
+    };
+    // The first message initializes the window, it's not what we measure.
+    sendMessage();
+    m_backend.resetCallCounts();
+    sendMessage();
+    const QHash<QByteArray, int> counts = m_backend.callCounts();
+    QList<QByteArray> functions = counts.keys();
+    std::sort(functions.begin(), functions.end(),
+              [&counts](const QByteArray &lhs, const QByteArray &rhs) {
+                  const int lhsCount = counts.value(lhs);
+                  const int rhsCount = counts.value(rhs);
+                  return (lhsCount != rhsCount) ? (lhsCount > rhsCount)
+                                                : (lhs < rhs);
+              });
+    QStringList calls = {};
+    for (auto &&function : qAsConst(functions)) {
+        calls.append(QString::fromUtf8("%1 %2").arg(
+            QString::fromUtf8(function),
+            QString::number(counts.value(function))));
+    }
+    qDebug().noquote() << QString::fromUtf8("%1 Win32 calls per message: %2")
+                              .arg(m_backend.totalCallCount())
+                              .arg(calls.join(QString::fromUtf8(", ")));
+    QBENCHMARK {
+        for (int i = 0; i != m_messages; ++i) {
+            sendMessage();
+        }
+    }
+}
+
+QTEST_MAIN(WinMessagesBenchmark)
+
+#include "winmessages.moc"
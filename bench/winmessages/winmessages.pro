@@ -0,0 +1,4 @@
+TARGET = winmessages
+TEMPLATE = app
+include(../../tests/win32fake/win32fake.pri)
+SOURCES += winmessages.cpp
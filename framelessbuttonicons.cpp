@@ -0,0 +1,131 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "framelessbuttonicons.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QImageReader>
+#include <QStringList>
+
+namespace {
+
+// The default size of the caption buttons, in device independent pixels.
+const QSize m_defaultButtonSize = {45, 30};
+
+QString getButtonName(const FramelessButtonIcons::Button button,
+                      const FramelessButtonIcons::Theme theme) {
+    QString name = {};
+    switch (button) {
+    case FramelessButtonIcons::Button::Minimize:
+        name = QString::fromUtf8("minimize");
+        break;
+    case FramelessButtonIcons::Button::Maximize:
+        name = QString::fromUtf8("maximize");
+        break;
+    case FramelessButtonIcons::Button::Restore:
+        name = QString::fromUtf8("restore");
+        break;
+    case FramelessButtonIcons::Button::Close:
+        name = QString::fromUtf8("close");
+        break;
+    }
+    return name +
+        (theme == FramelessButtonIcons::Theme::Dark
+             ? QString::fromUtf8("_white")
+             : QString::fromUtf8("_black"));
+}
+
+bool isValidButtonName(const QString &name) {
+    static const QStringList names = {
+        QString::fromUtf8("minimize_black"), QString::fromUtf8("minimize_white"),
+        QString::fromUtf8("maximize_black"), QString::fromUtf8("maximize_white"),
+        QString::fromUtf8("restore_black"),  QString::fromUtf8("restore_white"),
+        QString::fromUtf8("close_black"),    QString::fromUtf8("close_white")};
+    return names.contains(name);
+}
+
+} // namespace
+
+QHash<QString, QPixmap> FramelessButtonIcons::m_pixmaps = {};
+
+QPixmap FramelessButtonIcons::pixmap(const Button button, const Theme theme,
+                                     const QSize &size, const qreal dpr) {
+    const qreal ratio = dpr > 0.0 ? dpr : 1.0;
+    const QSize logicalSize = size.isEmpty() ? m_defaultButtonSize : size;
+    QPixmap result = pixmap(getButtonName(button, theme), logicalSize * ratio);
+    result.setDevicePixelRatio(ratio);
+    return result;
+}
+
+QPixmap FramelessButtonIcons::pixmap(const QString &name, const QSize &size) {
+    if (!isValidButtonName(name)) {
+        qWarning().noquote() << "Unknown caption button glyph:" << name;
+        return {};
+    }
+    const QSize pixelSize = size.isEmpty() ? m_defaultButtonSize : size;
+    const QString key = QString::fromUtf8("%1_%2x%3")
+                            .arg(name)
+                            .arg(pixelSize.width())
+                            .arg(pixelSize.height());
+    const auto it = m_pixmaps.constFind(key);
+    if (it != m_pixmaps.constEnd()) {
+        return it.value();
+    }
+    // QImageReader goes through the SVG image format plugin, the same way the
+    // Image element does, so we don't need to link against QtSvg.
+    QImageReader reader(QString::fromUtf8(":/images/button_%1.svg").arg(name));
+    reader.setScaledSize(pixelSize);
+    const QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning().noquote() << "Failed to rasterize" << name << ':'
+                             << reader.errorString();
+        return {};
+    }
+    if (m_pixmaps.isEmpty()) {
+        // QPixmap must not outlive the GUI application, drop the glyphs while
+        // it's being destroyed.
+        qAddPostRoutine([]() { m_pixmaps.clear(); });
+    }
+    const QPixmap result = QPixmap::fromImage(image);
+    m_pixmaps.insert(key, result);
+    return result;
+}
+
+#ifdef QT_QUICK_LIB
+FramelessButtonImageProvider::FramelessButtonImageProvider()
+    : QQuickImageProvider(QQuickImageProvider::Pixmap) {}
+
+QPixmap FramelessButtonImageProvider::requestPixmap(const QString &id,
+                                                    QSize *size,
+                                                    const QSize &requestedSize) {
+    // The Qt Quick pixmap cache keeps the texture of every (id, size) pair
+    // alive, so only the very first request of each pair ends up here.
+    const QPixmap result = FramelessButtonIcons::pixmap(id, requestedSize);
+    if (size) {
+        *size = result.size();
+    }
+    return result;
+}
+#endif
@@ -0,0 +1,92 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QPixmap>
+#ifdef QT_QUICK_LIB
+#include <QQuickImageProvider>
+#endif
+
+#if (QT_VERSION < QT_VERSION_CHECK(5, 13, 0))
+#define Q_DISABLE_MOVE(Class)                                                  \
+    Class(Class &&) = delete;                                                  \
+    Class &operator=(Class &&) = delete;
+
+#define Q_DISABLE_COPY_MOVE(Class)                                             \
+    Q_DISABLE_COPY(Class)                                                      \
+    Q_DISABLE_MOVE(Class)
+#endif
+
+// Rasterizes the caption button glyphs in "qrc:/images" once per size, device
+// pixel ratio and theme and keeps the results until the application quits, so
+// switching button states or themes never goes through the SVG renderer again.
+// Unlike QPixmapCache, nothing evicts them in between. There are only a few
+// button sizes per application, so the cache stays small.
+class FramelessButtonIcons {
+    Q_DISABLE_COPY_MOVE(FramelessButtonIcons)
+
+public:
+    enum class Button { Minimize, Maximize, Restore, Close };
+    // Light theme uses the black glyphs, dark theme uses the white ones.
+    enum class Theme { Light, Dark };
+
+    // The size is in device independent pixels, the returned pixmap has it's
+    // device pixel ratio set already.
+    static QPixmap pixmap(const Button button, const Theme theme,
+                          const QSize &size, const qreal dpr);
+
+    // Same as above, but the size is in device pixels. The name is the one
+    // used by the image provider, such as "close_white".
+    static QPixmap pixmap(const QString &name, const QSize &size);
+
+private:
+    FramelessButtonIcons() = default;
+
+    // Key: glyph name and pixel size. Only touched from the GUI thread, the
+    // pixmap image provider is always called there.
+    static QHash<QString, QPixmap> m_pixmaps;
+};
+
+#ifdef QT_QUICK_LIB
+// Usage:
+// engine.addImageProvider(QString::fromUtf8("framelessbuttons"),
+//                         new FramelessButtonImageProvider);
+// Image {
+//     source: "image://framelessbuttons/close_black"
+//     sourceSize: Qt.size(width * Screen.devicePixelRatio,
+//                         height * Screen.devicePixelRatio)
+// }
+class FramelessButtonImageProvider : public QQuickImageProvider {
+    Q_DISABLE_COPY_MOVE(FramelessButtonImageProvider)
+
+public:
+    explicit FramelessButtonImageProvider();
+    ~FramelessButtonImageProvider() override = default;
+
+    QPixmap requestPixmap(const QString &id, QSize *size,
+                          const QSize &requestedSize) override;
+};
+#endif
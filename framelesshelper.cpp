@@ -23,27 +23,411 @@
  */
 
 #include "framelesshelper.h"
+#include "x11nativeeventfilter.h"
 
+#include <QCoreApplication>
 #include <QDebug>
+#include <QFile>
+#include <QFileSystemWatcher>
 #include <QGuiApplication>
 #include <QMargins>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTimer>
 #include <QScreen>
+#include <QSharedPointer>
+#include <QStyleHints>
+#include <QtEndian>
 #ifdef QT_WIDGETS_LIB
+#include <QLayout>
 #include <QWidget>
 #endif
 #ifdef QT_QUICK_LIB
 #include <QQuickItem>
+#include <QQuickWindow>
 #endif
 #include <QEvent>
+#include <QLineF>
 #include <QMouseEvent>
+#include <QPainter>
+#include <QPalette>
+#include <QPixmapCache>
+#include <QRegion>
+#include <QRasterWindow>
+#include <QResizeEvent>
 #include <QTouchEvent>
 #include <QWindow>
+#include <QtMath>
+#include <algorithm>
+#include <cstring>
 #include <qpa/qplatformnativeinterface.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 Q_DECLARE_METATYPE(QMargins)
 
 namespace {
 
+// The offset between two cascaded windows, the same as the default title bar
+// height so that every title bar stays visible.
+const int m_cascadeStep = 30;
+
+// Live resize: at most one layout pass per frame budget, two resize events
+// closer than the burst interval start a session, and the session ends once
+// no resize event arrived for the settle delay.
+const int m_liveResizeFrameBudget = 16;
+const int m_liveResizeBurstInterval = 50;
+const int m_liveResizeSettleDelay = 100;
+
+// Snapping: window edges closer than the snap distance to a snap line stick
+// to it, and dragging the mouse into the zone along a screen edge tiles the
+// window to half or a quarter of the screen.
+const int m_snapDistance = 12;
+const int m_snapZoneSize = 8;
+
+using SCREENINFO = struct _SCREENINFO {
+    QRect geometry = {}, availableGeometry = {};
+    qreal devicePixelRatio = 1.0;
+    // Metrics of the desktop, in device independent pixels.
+    int borderWidth = 8, borderHeight = 8, titleBarHeight = 30;
+};
+
+// Xcursor's default cursor size at 96 DPI.
+const int m_defaultCursorSize = 24;
+
+bool isKdeSession() {
+    return qEnvironmentVariable("XDG_CURRENT_DESKTOP")
+        .contains(QString::fromUtf8("KDE"), Qt::CaseInsensitive);
+}
+
+QString getKWinConfigPath() {
+    return QStandardPaths::locate(QStandardPaths::GenericConfigLocation,
+                                  QString::fromUtf8("kwinrc"));
+}
+
+// The size of the resize cursors, in device independent pixels.
+int getCursorSize(const QScreen *const screen, const qreal scale) {
+    bool ok = false;
+    int size = qEnvironmentVariableIntValue("XCURSOR_SIZE", &ok);
+    if (!ok || (size <= 0)) {
+        size = X11NativeEventFilter::getXResource(
+                   QByteArrayLiteral("Xcursor.size"))
+                   .toInt(&ok);
+    }
+    if (!ok || (size <= 0)) {
+        return qRound(m_defaultCursorSize * scale);
+    }
+    // Xcursor sizes are in native pixels.
+    return qRound(size / screen->devicePixelRatio());
+}
+
+// The border KWin draws around normal windows, zero if KWin isn't running.
+// The sizes are the ones of Breeze, in units of it's small spacing (two
+// pixels at 96 DPI).
+int getKWinBorderSize(const qreal scale) {
+    if (!isKdeSession()) {
+        return 0;
+    }
+    const QString path = getKWinConfigPath();
+    if (path.isEmpty()) {
+        return 0;
+    }
+    static const QHash<QString, int> units = {
+        {QString::fromUtf8("None"), 0},
+        {QString::fromUtf8("NoSides"), 0},
+        {QString::fromUtf8("Tiny"), 1},
+        {QString::fromUtf8("Normal"), 2},
+        {QString::fromUtf8("Large"), 3},
+        {QString::fromUtf8("VeryLarge"), 4},
+        {QString::fromUtf8("Huge"), 5},
+        {QString::fromUtf8("VeryHuge"), 6},
+        {QString::fromUtf8("Oversized"), 10}};
+    const QSettings settings(path, QSettings::IniFormat);
+    const QString size =
+        settings
+            .value(QString::fromUtf8("org.kde.kdecoration2/BorderSize"),
+                   QString::fromUtf8("Normal"))
+            .toString();
+    return qRound(units.value(size, 2) * 2 * scale);
+}
+
+// The resize border and title bar of the desktop. Qt applies Xft.dpi (or
+// Xft/DPI of XSETTINGS) to the logical DPI already, what's left after it's
+// own high DPI scaling is the scale of the desktop. The resize cursors are
+// easy to hit if the border is a third of their size, that's 8 pixels for
+// the default size of 24 pixels, and a large border drawn by KWin is
+// expected to be grabbable as a whole.
+void readPlatformMetrics(const QScreen *const screen, SCREENINFO &info) {
+    const qreal scale = screen->logicalDotsPerInch() / 96.0;
+    const int border =
+        qMax(getCursorSize(screen, scale) / 3, getKWinBorderSize(scale));
+    info.borderWidth = qMax(1, border);
+    info.borderHeight = qMax(1, border);
+    info.titleBarHeight = qMax(1, qRound(info.titleBarHeight * scale));
+}
+
+// Geometries and metrics of all screens. They are only refreshed when Qt
+// tells us that the screen topology or the DPI has changed (or the settings
+// of the desktop, see FramelessHelper::watchPlatformMetrics()), never
+// when placing a window or per event.
+QHash<QScreen *, SCREENINFO> m_screenInfos;
+bool m_screenInfosTracked = false;
+
+void updateScreenInfo(QScreen *const screen) {
+    if (screen) {
+        SCREENINFO info;
+        info.geometry = screen->geometry();
+        info.availableGeometry = screen->availableGeometry();
+        info.devicePixelRatio = screen->devicePixelRatio();
+        readPlatformMetrics(screen, info);
+        m_screenInfos.insert(screen, info);
+    }
+}
+
+void trackScreen(QScreen *const screen) {
+    if (!screen) {
+        return;
+    }
+    updateScreenInfo(screen);
+    const auto update = [screen]() { updateScreenInfo(screen); };
+    QObject::connect(screen, &QScreen::geometryChanged, update);
+    QObject::connect(screen, &QScreen::availableGeometryChanged, update);
+    QObject::connect(screen, &QScreen::logicalDotsPerInchChanged, update);
+}
+
+SCREENINFO getScreenInfo(QScreen *const screen) {
+    if (!m_screenInfosTracked) {
+        m_screenInfosTracked = true;
+        const auto screens = QGuiApplication::screens();
+        for (auto &&_screen : qAsConst(screens)) {
+            trackScreen(_screen);
+        }
+        QObject::connect(qGuiApp, &QGuiApplication::screenAdded, trackScreen);
+        QObject::connect(
+            qGuiApp, &QGuiApplication::screenRemoved,
+            [](QScreen *_screen) { m_screenInfos.remove(_screen); });
+    }
+    return m_screenInfos.value(screen ? screen
+                                      : QGuiApplication::primaryScreen());
+}
+
+void refreshScreenInfos() {
+    const auto screens = m_screenInfos.keys();
+    for (auto &&screen : qAsConst(screens)) {
+        updateScreenInfo(screen);
+    }
+}
+
+QScreen *getWindowScreen(QObject *const obj) {
+    if (obj) {
+        if (obj->isWindowType()) {
+            const auto window = qobject_cast<QWindow *>(obj);
+            if (window) {
+                return window->screen();
+            }
+        }
+#ifdef QT_WIDGETS_LIB
+        else if (obj->isWidgetType()) {
+            const auto widget = qobject_cast<QWidget *>(obj);
+            if (widget) {
+                return widget->screen();
+            }
+        }
+#endif
+    }
+    return nullptr;
+}
+
+QRect getWindowGeometry(QObject *const obj) {
+    if (obj) {
+        if (obj->isWindowType()) {
+            const auto window = qobject_cast<QWindow *>(obj);
+            if (window) {
+                return window->geometry();
+            }
+        }
+#ifdef QT_WIDGETS_LIB
+        else if (obj->isWidgetType()) {
+            const auto widget = qobject_cast<QWidget *>(obj);
+            if (widget) {
+                return widget->geometry();
+            }
+        }
+#endif
+    }
+    return {};
+}
+
+// Apply the final geometry with a single call. It's cheap for windows that
+// have not been shown yet: Qt just stores it and uses it when the native
+// window is created.
+void setWindowGeometry(QObject *const obj, const QRect &geometry,
+                       const bool positionOnly) {
+    if (!obj || !geometry.isValid()) {
+        return;
+    }
+    if (obj->isWindowType()) {
+        const auto window = qobject_cast<QWindow *>(obj);
+        if (window) {
+            if (positionOnly) {
+                window->setPosition(geometry.topLeft());
+            } else {
+                window->setGeometry(geometry);
+            }
+        }
+    }
+#ifdef QT_WIDGETS_LIB
+    else if (obj->isWidgetType()) {
+        const auto widget = qobject_cast<QWidget *>(obj);
+        if (widget && widget->isTopLevel()) {
+            if (positionOnly) {
+                widget->move(geometry.topLeft());
+            } else {
+                widget->setGeometry(geometry);
+            }
+        }
+    }
+#endif
+}
+
+// Clamp the size to the minimum and maximum size of the window.
+QSize getBoundedWindowSize(QObject *const obj, const QSize &size) {
+    QSize minimumSize = {}, maximumSize = {};
+    if (obj) {
+        if (obj->isWindowType()) {
+            const auto window = qobject_cast<QWindow *>(obj);
+            if (window) {
+                minimumSize = window->minimumSize();
+                maximumSize = window->maximumSize();
+            }
+        }
+#ifdef QT_WIDGETS_LIB
+        else if (obj->isWidgetType()) {
+            const auto widget = qobject_cast<QWidget *>(obj);
+            if (widget) {
+                minimumSize = widget->minimumSize();
+                maximumSize = widget->maximumSize();
+            }
+        }
+#endif
+    }
+    return size.expandedTo(minimumSize.expandedTo({1, 1}))
+        .boundedTo(maximumSize.isValid() ? maximumSize
+                                         : QSize(QWINDOWSIZE_MAX,
+                                                 QWINDOWSIZE_MAX));
+}
+
+// Prefer talking to the X11 window manager directly, it's the shortest path
+// from the button press to the window manager's grab. Only for a real mouse
+// press though: the direct path tells the window manager that button 1 is
+// down, drops the pointer grab and fakes the button release, which breaks
+// touch drags and can click the widget under the finger. Qt sends touch
+// drags through the XI2 touch grab of the window manager instead.
+int m_systemMoveResizes = 0;
+
+bool startSystemMoveResize(QWindow *const window, const QPointF &globalPoint,
+                           const Qt::Edges edges, const bool mouse) {
+    if (!window) {
+        return false;
+    }
+    ++m_systemMoveResizes;
+    if (mouse &&
+        X11NativeEventFilter::startSystemMoveResize(
+            window, globalPoint.toPoint(), edges)) {
+        return true;
+    }
+    return (edges == Qt::Edges{}) ? window->startSystemMove()
+                                  : window->startSystemResize(edges);
+}
+
+bool isWindowTopLevel(QObject *const window) {
+    if (window) {
+        if (window->isWindowType()) {
+            const auto win = qobject_cast<QWindow *>(window);
+            if (win) {
+                return win->isTopLevel();
+            }
+        }
+#ifdef QT_WIDGETS_LIB
+        else if (window->isWidgetType()) {
+            const auto widget = qobject_cast<QWidget *>(window);
+            if (widget) {
+                return widget->isTopLevel();
+            }
+        }
+#endif
+    }
+    return false;
+}
+
+Qt::CursorShape getCursorShape(const Qt::Edges edges) {
+    if ((edges.testFlag(Qt::Edge::TopEdge) &&
+         edges.testFlag(Qt::Edge::LeftEdge)) ||
+        (edges.testFlag(Qt::Edge::BottomEdge) &&
+         edges.testFlag(Qt::Edge::RightEdge))) {
+        return Qt::CursorShape::SizeFDiagCursor;
+    }
+    if ((edges.testFlag(Qt::Edge::TopEdge) &&
+         edges.testFlag(Qt::Edge::RightEdge)) ||
+        (edges.testFlag(Qt::Edge::BottomEdge) &&
+         edges.testFlag(Qt::Edge::LeftEdge))) {
+        return Qt::CursorShape::SizeBDiagCursor;
+    }
+    if (edges.testFlag(Qt::Edge::TopEdge) ||
+        edges.testFlag(Qt::Edge::BottomEdge)) {
+        return Qt::CursorShape::SizeVerCursor;
+    }
+    if (edges.testFlag(Qt::Edge::LeftEdge) ||
+        edges.testFlag(Qt::Edge::RightEdge)) {
+        return Qt::CursorShape::SizeHorCursor;
+    }
+    return Qt::CursorShape::ArrowCursor;
+}
+
+// The geometry of an embedded window (or it's container), in the
+// coordinates of it's top level window. Invalid if it's hidden.
+QRect getEmbeddedGeometry(QObject *const container) {
+    if (!container) {
+        return {};
+    }
+#ifdef QT_WIDGETS_LIB
+    if (container->isWidgetType()) {
+        const auto widget = qobject_cast<QWidget *>(container);
+        if (!widget || !widget->isVisible()) {
+            return {};
+        }
+        return {widget->mapTo(widget->window(), QPoint(0, 0)),
+                widget->size()};
+    }
+#endif
+    if (container->isWindowType()) {
+        const auto window = qobject_cast<QWindow *>(container);
+        if (!window || !window->isVisible()) {
+            return {};
+        }
+        QPoint offset = {};
+        for (QWindow *parent = window; parent->parent();
+             parent = parent->parent()) {
+            offset += parent->position();
+        }
+        return {offset, window->size()};
+    }
+    return {};
+}
+
+bool isInSpecificAreas(const QPointF &point, const QVector<QRect> &areas) {
+    for (auto &&area : qAsConst(areas)) {
+        if (area.contains(point.x(), point.y())) {
+            return true;
+        }
+    }
+    return false;
+}
+
 QWindow *getWindowHandle(QObject *const val) {
     if (val) {
         const auto validWindow = [](QWindow *const window) -> QWindow * {
@@ -69,118 +453,816 @@ QWindow *getWindowHandle(QObject *const val) {
     return nullptr;
 }
 
-} // namespace
+// Layout of the window state file, all integers are little endian:
+// Header: "FLHS" | quint16 version | quint16 record count
+// Record: quint64 key hash | qint32 x, y, width, height |
+//         quint32 screen name hash | quint8 flags | 3 bytes padding
+const char m_stateFileMagic[] = {'F', 'L', 'H', 'S'};
+const quint16 m_stateFileVersion = 1;
+const int m_stateFileHeaderSize = 8;
+const int m_stateRecordSize = 32;
+const quint8 m_stateFlagMaximized = 0x01;
 
-FramelessHelper::FramelessHelper(QObject *parent) : QObject(parent) {}
+using WINDOWSTATE = struct _WINDOWSTATE {
+    quint64 key = 0;
+    QRect geometry = {};
+    quint32 screen = 0;
+    bool maximized = false;
+};
 
-void FramelessHelper::updateQtFrame(QWindow *const window,
-                                    const int titleBarHeight) {
-    if (window && (titleBarHeight > 0)) {
-        // Reduce top frame to zero since we paint it ourselves. Use
-        // device pixel to avoid rounding errors.
-        const QMargins margins = {0, -titleBarHeight, 0, 0};
-        const QVariant marginsVar = QVariant::fromValue(margins);
-        // The dynamic property takes effect when creating the platform
-        // window.
-        window->setProperty("_q_windowsCustomMargins", marginsVar);
-        // If a platform window exists, change via native interface.
-        QPlatformWindow *const platformWindow = window->handle();
-        if (platformWindow) {
-            QGuiApplication::platformNativeInterface()->setWindowProperty(
-                platformWindow, QString::fromUtf8("WindowsCustomMargins"),
-                marginsVar);
-        }
+using STATEFILE = struct _STATEFILE {
+    QSharedPointer<QFile> file = {};
+    const uchar *data = nullptr;
+    qint64 size = 0;
+};
+
+// Memory mapped state files. Restoring dozens of windows from the same file
+// maps it only once.
+QHash<QString, STATEFILE> m_stateFiles;
+
+// FNV-1a, stable across runs (unlike qHash, which is seeded per process).
+quint64 getStableHash(const QString &str) {
+    quint64 hash = 14695981039346656037ULL;
+    const QByteArray data = str.toUtf8();
+    for (auto &&c : qAsConst(data)) {
+        hash ^= static_cast<quint8>(c);
+        hash *= 1099511628211ULL;
     }
+    return hash;
 }
 
-void FramelessHelper::moveWindowToDesktopCenter(QObject *const obj) {
-    if (!obj) {
-        return;
+quint32 getScreenHash(const QScreen *const screen) {
+    return screen ? static_cast<quint32>(getStableHash(screen->name())) : 0;
+}
+
+const STATEFILE *mapStateFile(const QString &fileName) {
+    const auto it = m_stateFiles.constFind(fileName);
+    if (it != m_stateFiles.constEnd()) {
+        return &it.value();
     }
-    if (obj->isWindowType()) {
-        const auto window = qobject_cast<QWindow *>(obj);
-        if (window) {
-            const QSize ss = window->screen()->size();
-            const int sw = ss.width();
-            const int sh = ss.height();
-            const int ww = window->width();
-            const int wh = window->height();
-            window->setX(qRound(static_cast<qreal>(sw - ww) / 2.0));
-            window->setY(qRound(static_cast<qreal>(sh - wh) / 2.0));
-        }
+    STATEFILE stateFile;
+    stateFile.file.reset(new QFile(fileName));
+    if (!stateFile.file->open(QFile::ReadOnly)) {
+        return nullptr;
     }
-#ifdef QT_WIDGETS_LIB
-    else if (obj->isWidgetType()) {
-        const auto widget = qobject_cast<QWidget *>(obj);
-        if (widget && widget->isTopLevel()) {
-            const QSize ss = widget->screen()->size();
-            const int sw = ss.width();
-            const int sh = ss.height();
-            const int ww = widget->width();
-            const int wh = widget->height();
-            widget->move(qRound(static_cast<qreal>(sw - ww) / 2.0),
-                         qRound(static_cast<qreal>(sh - wh) / 2.0));
+    stateFile.size = stateFile.file->size();
+    if (stateFile.size < m_stateFileHeaderSize) {
+        return nullptr;
+    }
+    stateFile.data = stateFile.file->map(0, stateFile.size);
+    if (!stateFile.data ||
+        (memcmp(stateFile.data, m_stateFileMagic, sizeof(m_stateFileMagic)) !=
+         0) ||
+        (qFromLittleEndian<quint16>(stateFile.data + 4) !=
+         m_stateFileVersion)) {
+        return nullptr;
+    }
+    return &m_stateFiles.insert(fileName, stateFile).value();
+}
+
+void unmapStateFile(const QString &fileName) {
+    // QFile unmaps on close/destruction. The file must not be mapped while
+    // it's being replaced.
+    m_stateFiles.remove(fileName);
+}
+
+QVector<WINDOWSTATE> readStateRecords(const STATEFILE *const stateFile) {
+    QVector<WINDOWSTATE> records{};
+    if (!stateFile) {
+        return records;
+    }
+    const int count = qFromLittleEndian<quint16>(stateFile->data + 6);
+    if ((m_stateFileHeaderSize + count * m_stateRecordSize) >
+        stateFile->size) {
+        return records;
+    }
+    records.reserve(count);
+    for (int i = 0; i != count; ++i) {
+        const uchar *const rec =
+            stateFile->data + m_stateFileHeaderSize + i * m_stateRecordSize;
+        WINDOWSTATE state;
+        state.key = qFromLittleEndian<quint64>(rec);
+        state.geometry = {qFromLittleEndian<qint32>(rec + 8),
+                          qFromLittleEndian<qint32>(rec + 12),
+                          qFromLittleEndian<qint32>(rec + 16),
+                          qFromLittleEndian<qint32>(rec + 20)};
+        state.screen = qFromLittleEndian<quint32>(rec + 24);
+        state.maximized = rec[28] & m_stateFlagMaximized;
+        records.append(state);
+    }
+    return records;
+}
+
+bool findStateRecord(const STATEFILE *const stateFile, const quint64 key,
+                     WINDOWSTATE *const state) {
+    if (!stateFile || !state) {
+        return false;
+    }
+    // Scan the mapped memory directly, no need to decode every record.
+    const int count = qFromLittleEndian<quint16>(stateFile->data + 6);
+    if ((m_stateFileHeaderSize + count * m_stateRecordSize) >
+        stateFile->size) {
+        return false;
+    }
+    for (int i = 0; i != count; ++i) {
+        const uchar *const rec =
+            stateFile->data + m_stateFileHeaderSize + i * m_stateRecordSize;
+        if (qFromLittleEndian<quint64>(rec) != key) {
+            continue;
         }
+        state->key = key;
+        state->geometry = {qFromLittleEndian<qint32>(rec + 8),
+                           qFromLittleEndian<qint32>(rec + 12),
+                           qFromLittleEndian<qint32>(rec + 16),
+                           qFromLittleEndian<qint32>(rec + 20)};
+        state->screen = qFromLittleEndian<quint32>(rec + 24);
+        state->maximized = rec[28] & m_stateFlagMaximized;
+        return true;
     }
-#endif
-    else {
-        qWarning().noquote() << "The given QObject is not a top level window.";
+    return false;
+}
+
+bool writeStateRecords(const QString &fileName,
+                       const QVector<WINDOWSTATE> &records) {
+    QByteArray data(m_stateFileHeaderSize + records.count() * m_stateRecordSize,
+                    '\0');
+    const auto buf = reinterpret_cast<uchar *>(data.data());
+    memcpy(buf, m_stateFileMagic, sizeof(m_stateFileMagic));
+    qToLittleEndian<quint16>(m_stateFileVersion, buf + 4);
+    qToLittleEndian<quint16>(static_cast<quint16>(records.count()), buf + 6);
+    for (int i = 0; i != records.count(); ++i) {
+        const WINDOWSTATE &state = records.at(i);
+        uchar *const rec = buf + m_stateFileHeaderSize + i * m_stateRecordSize;
+        qToLittleEndian<quint64>(state.key, rec);
+        qToLittleEndian<qint32>(state.geometry.x(), rec + 8);
+        qToLittleEndian<qint32>(state.geometry.y(), rec + 12);
+        qToLittleEndian<qint32>(state.geometry.width(), rec + 16);
+        qToLittleEndian<qint32>(state.geometry.height(), rec + 20);
+        qToLittleEndian<quint32>(state.screen, rec + 24);
+        rec[28] = state.maximized ? m_stateFlagMaximized : 0;
+    }
+    unmapStateFile(fileName);
+    QSaveFile file(fileName);
+    if (!file.open(QSaveFile::WriteOnly)) {
+        qWarning().noquote() << "Failed to save the window state:"
+                             << file.errorString();
+        return false;
     }
+    file.write(data);
+    return file.commit();
 }
 
-int FramelessHelper::getBorderWidth() const { return m_borderWidth; }
+int m_platformWindowRecreations = 0;
+// All the helpers of the application, and whether the desktop settings they
+// share are being watched, see FramelessHelper::watchPlatformMetrics().
+QVector<FramelessHelper *> m_helpers;
+bool m_platformMetricsWatched = false;
+int m_handledMouseMoves = 0, m_coalescedMouseMoves = 0;
 
-void FramelessHelper::setBorderWidth(const int val) { m_borderWidth = val; }
+void reportLateFlagChange(QObject *const obj) {
+    ++m_platformWindowRecreations;
+    qWarning().noquote()
+        << "The frameless flags of" << obj
+        << "are applied after it's native window has been created, Qt has "
+           "to recreate it. Call removeWindowFrame() before the window is "
+           "shown to avoid this.";
+}
 
-int FramelessHelper::getBorderHeight() const { return m_borderHeight; }
+// The largest radius of blurColumns(), the sums of a window of that size
+// still fit into 16 bits.
+const int m_maximumBlurRadius = 128;
 
-void FramelessHelper::setBorderHeight(const int val) { m_borderHeight = val; }
+// Blur the columns of a square 8 bit image with a running sum, so the cost
+// doesn't depend on the radius. Both images have (radius) rows of zeros
+// above and (radius + 1) rows of zeros below them, so every row is handled
+// the same way. Each row is one pass over contiguous memory, the SSE2 and
+// NEON paths handle 16 and 8 pixels of it at a time.
+void blurColumns(const uchar *const source, uchar *const target,
+                 const int size, const int radius, quint16 *const sums) {
+    const int window = (radius * 2) + 1;
+    // (sum * scale) >> 16 instead of (sum / window).
+    const int scale = ((1 << 16) + window - 1) / window;
+    memset(sums, 0, size * sizeof(quint16));
+    for (int y = 0; y != window; ++y) {
+        const uchar *const row = source + (y * size);
+        for (int x = 0; x != size; ++x) {
+            sums[x] += row[x];
+        }
+    }
+    for (int y = 0; y != size; ++y) {
+        const uchar *const leaving = source + (y * size);
+        const uchar *const entering = source + ((y + window) * size);
+        uchar *const row = target + ((y + radius) * size);
+        int x = 0;
+#ifdef __SSE2__
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i factor = _mm_set1_epi16(static_cast<short>(scale));
+        for (; (x + 16) <= size; x += 16) {
+            const auto low = reinterpret_cast<__m128i *>(sums + x);
+            const auto high = reinterpret_cast<__m128i *>(sums + x + 8);
+            const __m128i sumLow = _mm_loadu_si128(low);
+            const __m128i sumHigh = _mm_loadu_si128(high);
+            const __m128i result =
+                _mm_packus_epi16(_mm_mulhi_epu16(sumLow, factor),
+                                 _mm_mulhi_epu16(sumHigh, factor));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(row + x), result);
+            const __m128i in = _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(entering + x));
+            const __m128i out = _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(leaving + x));
+            _mm_storeu_si128(
+                low, _mm_sub_epi16(_mm_add_epi16(sumLow,
+                                                 _mm_unpacklo_epi8(in, zero)),
+                                   _mm_unpacklo_epi8(out, zero)));
+            _mm_storeu_si128(
+                high, _mm_sub_epi16(_mm_add_epi16(sumHigh,
+                                                  _mm_unpackhi_epi8(in, zero)),
+                                    _mm_unpackhi_epi8(out, zero)));
+        }
+#elif defined(__ARM_NEON)
+        const uint16x4_t factor = vdup_n_u16(static_cast<quint16>(scale));
+        for (; (x + 8) <= size; x += 8) {
+            const uint16x8_t sum = vld1q_u16(sums + x);
+            const uint16x8_t scaled = vcombine_u16(
+                vshrn_n_u32(vmull_u16(vget_low_u16(sum), factor), 16),
+                vshrn_n_u32(vmull_u16(vget_high_u16(sum), factor), 16));
+            vst1_u8(row + x, vqmovn_u16(scaled));
+            vst1q_u16(sums + x,
+                      vsubq_u16(vaddw_u8(sum, vld1_u8(entering + x)),
+                                vmovl_u8(vld1_u8(leaving + x))));
+        }
+#endif
+        for (; x != size; ++x) {
+            row[x] = static_cast<uchar>(
+                qMin((static_cast<quint32>(sums[x]) * scale) >> 16, 255u));
+            sums[x] += entering[x] - leaving[x];
+        }
+    }
+}
 
-int FramelessHelper::getTitleBarHeight() const { return m_titleBarHeight; }
+// Mirror a square 8 bit image at it's diagonal in place, to blur it's rows
+// with blurColumns().
+void transposeImage(uchar *const image, const int size) {
+    for (int y = 0; y != size; ++y) {
+        for (int x = y + 1; x != size; ++x) {
+            std::swap(image[(y * size) + x], image[(x * size) + y]);
+        }
+    }
+}
 
-void FramelessHelper::setTitleBarHeight(const int val) {
-    m_titleBarHeight = val;
+// The shadow of a window, as a nine-patch: the corners are (radius * 2)
+// pixels large and the edges are stretched from the single pixel in the
+// middle. It's generated only once per radius, colour and DPR.
+QPixmap getShadowPixmap(const int radius, const QColor &color,
+                        const qreal dpr) {
+    const QString key = QString::fromUtf8("flh_shadow_%1_%2_%3")
+                            .arg(radius)
+                            .arg(color.rgba(), 0, 16)
+                            .arg(dpr);
+    QPixmap pixmap = {};
+    if (QPixmapCache::find(key, &pixmap)) {
+        return pixmap;
+    }
+    const int r = qMax(1, qRound(radius * dpr));
+    const int size = (r * 4) + 1;
+    // Three box blurs are very close to a gaussian blur.
+    const int boxRadius = qBound(1, r / 3, m_maximumBlurRadius);
+    // Two copies of the mask with the rows of zeros blurColumns() needs, one
+    // is blurred into the other.
+    QVector<uchar> front((size + (boxRadius * 2) + 1) * size, 0);
+    QVector<uchar> back(front.size(), 0);
+    const int offset = boxRadius * size;
+    for (int y = r; y != (size - r); ++y) {
+        memset(front.data() + offset + (y * size) + r, 0xFF, size - (r * 2));
+    }
+    QVector<quint16> sums(size);
+    for (int direction = 0; direction != 2; ++direction) {
+        for (int pass = 0; pass != 3; ++pass) {
+            blurColumns(front.constData(), back.data(), size, boxRadius,
+                        sums.data());
+            front.swap(back);
+        }
+        // The columns of the second round are the rows of the mask.
+        transposeImage(front.data() + offset, size);
+    }
+    QImage mask(size, size, QImage::Format_Alpha8);
+    for (int y = 0; y != size; ++y) {
+        memcpy(mask.scanLine(y), front.constData() + offset + (y * size), size);
+    }
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    {
+        QPainter painter(&image);
+        painter.drawImage(0, 0, mask);
+        painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+        painter.fillRect(image.rect(), color);
+    }
+    pixmap = QPixmap::fromImage(image);
+    pixmap.setDevicePixelRatio(dpr);
+    QPixmapCache::insert(key, pixmap);
+    return pixmap;
 }
 
-QVector<QRect> FramelessHelper::getIgnoreAreas(QObject *const obj) const {
-    if (!obj) {
-        return {};
+// Only the four corners and the four edges are drawn, the area below the
+// content is left alone.
+void drawShadow(QPainter *const painter, const QRect &rect, const int radius,
+                const QPixmap &pixmap) {
+    if (!painter || pixmap.isNull()) {
+        return;
+    }
+    const qreal c = radius * 2;
+    const qreal s = (pixmap.width() - 1) / 2;
+    const qreal w = rect.width(), h = rect.height();
+    const qreal x = rect.x(), y = rect.y();
+    const qreal ew = qMax(0.0, w - (c * 2)), eh = qMax(0.0, h - (c * 2));
+    // Corners.
+    painter->drawPixmap(QRectF(x, y, c, c), pixmap, QRectF(0, 0, s, s));
+    painter->drawPixmap(QRectF(x + w - c, y, c, c), pixmap,
+                        QRectF(s + 1, 0, s, s));
+    painter->drawPixmap(QRectF(x, y + h - c, c, c), pixmap,
+                        QRectF(0, s + 1, s, s));
+    painter->drawPixmap(QRectF(x + w - c, y + h - c, c, c), pixmap,
+                        QRectF(s + 1, s + 1, s, s));
+    // Edges.
+    if (ew > 0) {
+        painter->drawPixmap(QRectF(x + c, y, ew, c), pixmap,
+                            QRectF(s, 0, 1, s));
+        painter->drawPixmap(QRectF(x + c, y + h - c, ew, c), pixmap,
+                            QRectF(s, s + 1, 1, s));
+    }
+    if (eh > 0) {
+        painter->drawPixmap(QRectF(x, y + c, c, eh), pixmap,
+                            QRectF(0, s, s, 1));
+        painter->drawPixmap(QRectF(x + w - c, y + c, c, eh), pixmap,
+                            QRectF(s + 1, s, s, 1));
     }
-    return m_ignoreAreas.value(obj);
 }
 
-void FramelessHelper::setIgnoreAreas(QObject *const obj,
-                                     const QVector<QRect> &val) {
-    if (obj) {
-        m_ignoreAreas[obj] = val;
+using CORNERMASKS = struct _CORNERMASKS {
+    QRegion topLeft = {}, topRight = {}, bottomLeft = {}, bottomRight = {};
+};
+
+// The areas cut out of the four corners of a rounded window, one rectangle
+// per row. They only depend on the radius, so they are built once and the
+// mask of any size is the window rectangle minus the translated corners.
+// The region is in device independent pixels, Qt scales it for the DPR
+// itself.
+QHash<int, CORNERMASKS> m_cornerMasks;
+
+const CORNERMASKS &getCornerMasks(const int radius) {
+    const auto it = m_cornerMasks.constFind(radius);
+    if (it != m_cornerMasks.constEnd()) {
+        return *it;
+    }
+    CORNERMASKS masks;
+    for (int y = 0; y != radius; ++y) {
+        // Distance from the center of the circle to the middle of the row.
+        const qreal dy = radius - y - 0.5;
+        const int width =
+            radius - qRound(qSqrt(qMax(0.0, (radius * radius) - (dy * dy))));
+        if (width <= 0) {
+            continue;
+        }
+        masks.topLeft += QRect(0, y, width, 1);
+        masks.topRight += QRect(radius - width, y, width, 1);
+        masks.bottomLeft += QRect(0, radius - y - 1, width, 1);
+        masks.bottomRight += QRect(radius - width, radius - y - 1, width, 1);
     }
+    return *m_cornerMasks.insert(radius, masks);
 }
 
-void FramelessHelper::addIgnoreArea(QObject *const obj, const QRect &val) {
-    if (obj) {
-        QVector<QRect> areas = m_ignoreAreas[obj];
-        areas.append(val);
-        m_ignoreAreas[obj] = areas;
+QRegion getRoundedMask(const QSize &size, const int radius) {
+    const QRect rect = {{0, 0}, size};
+    if ((radius <= 0) || (size.width() < (radius * 2)) ||
+        (size.height() < (radius * 2))) {
+        return rect;
     }
+    const CORNERMASKS &masks = getCornerMasks(radius);
+    const int x = size.width() - radius, y = size.height() - radius;
+    return QRegion(rect)
+        .subtracted(masks.topLeft)
+        .subtracted(masks.topRight.translated(x, 0))
+        .subtracted(masks.bottomLeft.translated(0, y))
+        .subtracted(masks.bottomRight.translated(x, y));
 }
 
-void FramelessHelper::clearIgnoreAreas(QObject *const obj) {
-    if (obj) {
-        m_ignoreAreas[obj] = {};
+// The offset which moves one of the two edges onto the closest snap line of
+// the (sorted) table, or zero if none of them is close enough.
+int getSnapOffset(const QVector<int> &lines, const int first,
+                  const int second) {
+    int result = 0, distance = m_snapDistance + 1;
+    for (const int edge : {first, second}) {
+        const auto it = std::lower_bound(lines.cbegin(), lines.cend(), edge);
+        if ((it != lines.cend()) && ((*it - edge) < distance)) {
+            distance = *it - edge;
+            result = distance;
+        }
+        if ((it != lines.cbegin()) && ((edge - *(it - 1)) < distance)) {
+            distance = edge - *(it - 1);
+            result = -distance;
+        }
     }
+    return result;
 }
 
-QVector<QRect> FramelessHelper::getDraggableAreas(QObject *const obj) const {
-    if (!obj) {
-        return {};
+// Half or quarter of the available geometry if the cursor is in the zone
+// along the edges of a screen, or an invalid rectangle.
+QRect getSnapZone(const QVector<QRect> &screens,
+                  const QVector<QRect> &availableGeometries,
+                  const QPoint &pos) {
+    for (int i = 0; i != screens.size(); ++i) {
+        if (!screens.at(i).contains(pos)) {
+            continue;
+        }
+        const QRect rect = availableGeometries.at(i);
+        const bool left = pos.x() <= (rect.left() + m_snapZoneSize);
+        const bool right = pos.x() >= (rect.right() - m_snapZoneSize);
+        const bool top = pos.y() <= (rect.top() + m_snapZoneSize);
+        const bool bottom = pos.y() >= (rect.bottom() - m_snapZoneSize);
+        const int halfWidth = rect.width() / 2,
+                  halfHeight = rect.height() / 2;
+        if (!left && !right) {
+            return top ? rect : QRect();
+        }
+        QRect zone = rect;
+        zone.setWidth(halfWidth);
+        if (right) {
+            zone.moveRight(rect.right());
+        }
+        if (top || bottom) {
+            zone.setHeight(halfHeight);
+            if (bottom) {
+                zone.moveBottom(rect.bottom());
+            }
+        }
+        return zone;
     }
-    return m_draggableAreas.value(obj);
+    return {};
 }
 
-void FramelessHelper::setDraggableAreas(QObject *const obj,
-                                        const QVector<QRect> &val) {
-    if (obj) {
-        m_draggableAreas[obj] = val;
+// The outline of the proposed geometry in the outline resize mode. It's a
+// frameless window masked to a thin ring, so it doesn't need a compositor
+// and doesn't hide anything below it.
+class OutlineWindow : public QRasterWindow {
+public:
+    explicit OutlineWindow(QScreen *const screen) {
+        setFlags(Qt::ToolTip | Qt::FramelessWindowHint |
+                 Qt::WindowStaysOnTopHint |
+                 Qt::WindowTransparentForInput |
+                 Qt::WindowDoesNotAcceptFocus);
+        setScreen(screen);
+    }
+    ~OutlineWindow() override = default;
+
+protected:
+    void paintEvent(QPaintEvent *event) override {
+        Q_UNUSED(event)
+        QPainter painter(this);
+        painter.fillRect(QRect({0, 0}, size()),
+                         QGuiApplication::palette().color(QPalette::Highlight));
+    }
+
+    void resizeEvent(QResizeEvent *event) override {
+        QRasterWindow::resizeEvent(event);
+        const QRect rect = {{0, 0}, event->size()};
+        setMask(QRegion(rect).subtracted(
+            rect.adjusted(m_thickness, m_thickness, -m_thickness,
+                          -m_thickness)));
+    }
+
+private:
+    const int m_thickness = 2;
+};
+
+} // namespace
+
+FramelessHelper::FramelessHelper(QObject *parent) : QObject(parent) {
+    m_helpers.append(this);
+    watchPlatformMetrics();
+}
+
+FramelessHelper::~FramelessHelper() {
+    setNativeEventFilterEnabled(false);
+    m_helpers.removeAll(this);
+}
+
+void FramelessHelper::watchPlatformMetrics() {
+    // Once per application, for all the helpers. The listeners are owned
+    // by the application and go away with it.
+    if (m_platformMetricsWatched || !qApp) {
+        return;
+    }
+    m_platformMetricsWatched = true;
+    const auto changed = []() {
+        refreshScreenInfos();
+        for (auto &&helper : qAsConst(m_helpers)) {
+            helper->invalidatePlatformMetrics();
+        }
+    };
+    // The platform metrics are cached with the screens, read them again
+    // when the settings of KWin change.
+    if (isKdeSession()) {
+        const QString path = getKWinConfigPath();
+        if (!path.isEmpty()) {
+            const auto watcher = new QFileSystemWatcher({path}, qApp);
+            QObject::connect(
+                watcher, &QFileSystemWatcher::fileChanged, watcher,
+                [watcher, changed](const QString &fileName) {
+                    // KConfig replaces the file when saving it, which
+                    // removes it from the watcher.
+                    if (!watcher->files().contains(fileName) &&
+                        QFile::exists(fileName)) {
+                        watcher->addPath(fileName);
+                    }
+                    changed();
+                });
+        }
+    }
+    // And when the X resources (DPI, cursor size) change.
+    if (X11NativeEventFilter::isPlatformX11()) {
+        const auto listener = new X11ResourceListener(changed);
+        qApp->installNativeEventFilter(listener);
+        QObject::connect(qApp, &QObject::destroyed,
+                         [listener]() { delete listener; });
+    }
+    QObject::connect(qApp, &QObject::destroyed,
+                     []() { m_platformMetricsWatched = false; });
+}
+
+void FramelessHelper::updateQtFrame(QWindow *const window,
+                                    const int titleBarHeight) {
+    if (window && (titleBarHeight > 0)) {
+        // Reduce top frame to zero since we paint it ourselves. Use
+        // device pixel to avoid rounding errors.
+        const QMargins margins = {0, -titleBarHeight, 0, 0};
+        const QVariant marginsVar = QVariant::fromValue(margins);
+        // The dynamic property takes effect when creating the platform
+        // window.
+        window->setProperty("_q_windowsCustomMargins", marginsVar);
+        // If a platform window exists, change via native interface.
+        QPlatformWindow *const platformWindow = window->handle();
+        if (platformWindow) {
+            QGuiApplication::platformNativeInterface()->setWindowProperty(
+                platformWindow, QString::fromUtf8("WindowsCustomMargins"),
+                marginsVar);
+        }
+    }
+}
+
+void FramelessHelper::moveWindowToDesktopCenter(QObject *const obj) {
+    if (!obj) {
+        return;
+    }
+    placeWindows({obj}, Placement::Center, getWindowScreen(obj));
+}
+
+void FramelessHelper::placeWindows(const QVector<QObject *> &objs,
+                                   const Placement placement,
+                                   QScreen *const screen) {
+    QVector<QObject *> windows{};
+    if (!objs.isEmpty()) {
+        for (auto &&obj : qAsConst(objs)) {
+            if (getWindowGeometry(obj).isValid()) {
+                windows.append(obj);
+            } else {
+                qWarning().noquote()
+                    << "The given QObject is not a top level window.";
+            }
+        }
+    }
+    if (windows.isEmpty()) {
+        return;
+    }
+    // Use the available geometry (without task bars and docks) of the
+    // screen, including it's origin in the virtual desktop. Otherwise windows
+    // on a secondary monitor would jump to the primary one.
+    const QRect area =
+        getScreenInfo(screen ? screen : getWindowScreen(windows.first()))
+            .availableGeometry;
+    if (!area.isValid()) {
+        return;
+    }
+    switch (placement) {
+    case Placement::Center: {
+        for (auto &&window : qAsConst(windows)) {
+            const QSize size = getWindowGeometry(window).size();
+            const QPoint pos = {
+                area.x() + qRound(static_cast<qreal>(area.width() -
+                                                     size.width()) /
+                                  2.0),
+                area.y() + qRound(static_cast<qreal>(area.height() -
+                                                     size.height()) /
+                                  2.0)};
+            setWindowGeometry(window, {pos, size}, true);
+        }
+    } break;
+    case Placement::Cascade: {
+        QPoint pos = area.topLeft();
+        for (auto &&window : qAsConst(windows)) {
+            const QSize size = getWindowGeometry(window).size();
+            if (((pos.x() + size.width()) > (area.x() + area.width())) ||
+                ((pos.y() + size.height()) > (area.y() + area.height()))) {
+                // Start over from the top-left corner of the screen.
+                pos = area.topLeft();
+            }
+            setWindowGeometry(window, {pos, size}, true);
+            pos += QPoint(m_cascadeStep, m_cascadeStep);
+        }
+    } break;
+    case Placement::Tile: {
+        const int count = windows.count();
+        const int columns = qCeil(qSqrt(static_cast<qreal>(count)));
+        const int rows = qCeil(static_cast<qreal>(count) / columns);
+        const int cw = area.width() / columns;
+        const int ch = area.height() / rows;
+        for (int i = 0; i != count; ++i) {
+            const QRect cell = {area.x() + (i % columns) * cw,
+                                area.y() + (i / columns) * ch, cw, ch};
+            setWindowGeometry(windows.at(i), cell, false);
+        }
+    } break;
+    }
+}
+
+bool FramelessHelper::saveWindowState(QObject *const obj, const QString &key,
+                                      const QString &fileName) {
+    if (!obj || key.isEmpty() || fileName.isEmpty()) {
+        return false;
+    }
+    WINDOWSTATE state;
+    state.key = getStableHash(key);
+    state.screen = getScreenHash(getWindowScreen(obj));
+    if (obj->isWindowType()) {
+        const auto window = qobject_cast<QWindow *>(obj);
+        if (window) {
+            state.maximized =
+                window->windowStates().testFlag(Qt::WindowMaximized);
+            state.geometry = window->geometry();
+        }
+    }
+#ifdef QT_WIDGETS_LIB
+    else if (obj->isWidgetType()) {
+        const auto widget = qobject_cast<QWidget *>(obj);
+        if (widget && widget->isTopLevel()) {
+            state.maximized = widget->isMaximized();
+            state.geometry = widget->normalGeometry();
+        }
+    }
+#endif
+    if (!state.geometry.isValid()) {
+        qWarning().noquote() << "The given QObject is not a top level window.";
+        return false;
+    }
+    QVector<WINDOWSTATE> records = readStateRecords(mapStateFile(fileName));
+    bool found = false;
+    for (auto &&record : records) {
+        if (record.key == state.key) {
+            if (state.maximized && obj->isWindowType()) {
+                // QWindow doesn't know it's normal geometry, keep the one we
+                // saved last time.
+                state.geometry = record.geometry;
+            }
+            record = state;
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        records.append(state);
+    }
+    return writeStateRecords(fileName, records);
+}
+
+bool FramelessHelper::restoreWindowState(QObject *const obj,
+                                         const QString &key,
+                                         const QString &fileName) {
+    if (!obj || key.isEmpty() || fileName.isEmpty()) {
+        return false;
+    }
+    WINDOWSTATE state;
+    if (!findStateRecord(mapStateFile(fileName), getStableHash(key), &state) ||
+        !state.geometry.isValid()) {
+        return false;
+    }
+    QScreen *screen = nullptr;
+    const auto screens = QGuiApplication::screens();
+    for (auto &&_screen : qAsConst(screens)) {
+        if (getScreenHash(_screen) == state.screen) {
+            screen = _screen;
+            break;
+        }
+    }
+    // The monitor may have been unplugged or rearranged since the state was
+    // saved. Don't put the window somewhere the user can't reach it.
+    const bool reachable = screen &&
+        getScreenInfo(screen).availableGeometry.intersects(state.geometry);
+    if (obj->isWindowType()) {
+        const auto window = qobject_cast<QWindow *>(obj);
+        if (window) {
+            if (reachable) {
+                window->setScreen(screen);
+                window->setGeometry(state.geometry);
+            } else {
+                window->resize(state.geometry.size());
+                moveWindowToDesktopCenter(window);
+            }
+            if (state.maximized) {
+                window->setWindowStates(window->windowStates() |
+                                        Qt::WindowMaximized);
+            }
+        }
+    }
+#ifdef QT_WIDGETS_LIB
+    else if (obj->isWidgetType()) {
+        const auto widget = qobject_cast<QWidget *>(obj);
+        if (widget && widget->isTopLevel()) {
+            if (reachable) {
+                widget->setGeometry(state.geometry);
+            } else {
+                widget->resize(state.geometry.size());
+                moveWindowToDesktopCenter(widget);
+            }
+            if (state.maximized) {
+                widget->setWindowState(widget->windowState() |
+                                       Qt::WindowMaximized);
+            }
+        }
+    }
+#endif
+    return true;
+}
+
+int FramelessHelper::getPlatformWindowRecreationCount() {
+    return m_platformWindowRecreations;
+}
+
+int FramelessHelper::getHandledMouseMoveCount() { return m_handledMouseMoves; }
+
+int FramelessHelper::getSystemMoveResizeCount() { return m_systemMoveResizes; }
+
+int FramelessHelper::getCoalescedMouseMoveCount() {
+    return m_coalescedMouseMoves;
+}
+
+int FramelessHelper::getBorderWidth() const {
+    return getEffectiveBorderWidth(nullptr);
+}
+
+void FramelessHelper::setBorderWidth(const int val) { m_borderWidth = val; }
+
+int FramelessHelper::getBorderHeight() const {
+    return getEffectiveBorderHeight(nullptr);
+}
+
+void FramelessHelper::setBorderHeight(const int val) { m_borderHeight = val; }
+
+int FramelessHelper::getTitleBarHeight() const {
+    return getEffectiveTitleBarHeight(nullptr);
+}
+
+void FramelessHelper::setTitleBarHeight(const int val) {
+    m_titleBarHeight = val;
+}
+
+QVector<QRect> FramelessHelper::getIgnoreAreas(QObject *const obj) const {
+    if (!obj) {
+        return {};
+    }
+    return m_ignoreAreas.value(obj);
+}
+
+void FramelessHelper::setIgnoreAreas(QObject *const obj,
+                                     const QVector<QRect> &val) {
+    if (obj) {
+        m_ignoreAreas[obj] = val;
+    }
+}
+
+void FramelessHelper::addIgnoreArea(QObject *const obj, const QRect &val) {
+    if (obj) {
+        QVector<QRect> areas = m_ignoreAreas[obj];
+        areas.append(val);
+        m_ignoreAreas[obj] = areas;
+    }
+}
+
+void FramelessHelper::clearIgnoreAreas(QObject *const obj) {
+    if (obj) {
+        m_ignoreAreas[obj] = {};
+    }
+}
+
+QVector<QRect> FramelessHelper::getDraggableAreas(QObject *const obj) const {
+    if (!obj) {
+        return {};
+    }
+    return m_draggableAreas.value(obj);
+}
+
+void FramelessHelper::setDraggableAreas(QObject *const obj,
+                                        const QVector<QRect> &val) {
+    if (obj) {
+        m_draggableAreas[obj] = val;
     }
 }
 
@@ -192,464 +1274,1658 @@ void FramelessHelper::addDraggableArea(QObject *const obj, const QRect &val) {
     }
 }
 
-void FramelessHelper::clearDraggableAreas(QObject *const obj) {
-    if (obj) {
-        m_draggableAreas[obj] = {};
+void FramelessHelper::clearDraggableAreas(QObject *const obj) {
+    if (obj) {
+        m_draggableAreas[obj] = {};
+    }
+}
+
+QVector<QObject *> FramelessHelper::getIgnoreObjects(QObject *const obj) const {
+    if (!obj) {
+        return {};
+    }
+    QVector<QObject *> ret{};
+    const QVector<QPointer<QObject>> objs = m_ignoreObjects.value(obj);
+    if (!objs.isEmpty()) {
+        for (auto &&_obj : qAsConst(objs)) {
+            if (_obj) {
+                ret.append(_obj);
+            }
+        }
+    }
+    return ret;
+}
+
+void FramelessHelper::setIgnoreObjects(QObject *const obj,
+                                       const QVector<QObject *> &val) {
+    if (obj) {
+        QVector<QPointer<QObject>> objs{};
+        if (!val.isEmpty()) {
+            for (auto &&_obj : qAsConst(val)) {
+                objs.append(_obj);
+            }
+        }
+        m_ignoreObjects[obj] = objs;
+    }
+}
+
+void FramelessHelper::addIgnoreObject(QObject *const obj, QObject *val) {
+    if (obj) {
+        QVector<QPointer<QObject>> objs = m_ignoreObjects[obj];
+        objs.append(val);
+        m_ignoreObjects[obj] = objs;
+    }
+}
+
+void FramelessHelper::clearIgnoreObjects(QObject *const obj) {
+    if (obj) {
+        m_ignoreObjects[obj] = {};
+    }
+}
+
+QVector<QObject *>
+FramelessHelper::getDraggableObjects(QObject *const obj) const {
+    if (!obj) {
+        return {};
+    }
+    QVector<QObject *> ret{};
+    const QVector<QPointer<QObject>> objs = m_draggableObjects.value(obj);
+    if (!objs.isEmpty()) {
+        for (auto &&_obj : qAsConst(objs)) {
+            if (_obj) {
+                ret.append(_obj);
+            }
+        }
+    }
+    return ret;
+}
+
+void FramelessHelper::setDraggableObjects(QObject *const obj,
+                                          const QVector<QObject *> &val) {
+    if (obj) {
+        QVector<QPointer<QObject>> objs{};
+        if (!val.isEmpty()) {
+            for (auto &&_obj : qAsConst(val)) {
+                objs.append(_obj);
+            }
+        }
+        m_draggableObjects[obj] = objs;
+    }
+}
+
+void FramelessHelper::addDraggableObject(QObject *const obj, QObject *val) {
+    if (obj) {
+        QVector<QPointer<QObject>> objs = m_draggableObjects[obj];
+        objs.append(val);
+        m_draggableObjects[obj] = objs;
+    }
+}
+
+void FramelessHelper::clearDraggableObjects(QObject *const obj) {
+    if (obj) {
+        m_draggableObjects[obj] = {};
+    }
+}
+
+bool FramelessHelper::getResizable(QObject *const obj) const {
+    if (!obj) {
+        return true;
+    }
+    return !m_fixedSize.value(obj);
+}
+
+void FramelessHelper::setResizable(QObject *const obj, const bool val) {
+    if (obj) {
+        m_fixedSize[obj] = !val;
+    }
+}
+
+bool FramelessHelper::getTitleBarEnabled(QObject *const obj) const {
+    if (!obj) {
+        return true;
+    }
+    return !m_disableTitleBar.value(obj);
+}
+
+void FramelessHelper::setTitleBarEnabled(QObject *const obj, const bool val) {
+    if (obj) {
+        m_disableTitleBar[obj] = !val;
+    }
+}
+
+bool FramelessHelper::getLiveResizeEnabled(QObject *const obj) const {
+    if (!obj) {
+        return false;
+    }
+    return m_liveResizes.value(obj).enabled;
+}
+
+void FramelessHelper::setLiveResizeEnabled(QObject *const obj,
+                                           const bool val) {
+    if (obj) {
+        if (!val) {
+            stopLiveResize(obj);
+        }
+        m_liveResizes[obj].enabled = val;
+    }
+}
+
+bool FramelessHelper::getOutlineResizeEnabled(QObject *const obj) const {
+    if (!obj) {
+        return false;
+    }
+    return m_outlineResize.value(obj);
+}
+
+void FramelessHelper::setOutlineResizeEnabled(QObject *const obj,
+                                              const bool val) {
+    if (obj) {
+        m_outlineResize[obj] = val;
+    }
+}
+
+bool FramelessHelper::getShadowEnabled(QObject *const obj) const {
+    if (!obj) {
+        return false;
+    }
+    return m_shadows.value(obj).enabled;
+}
+
+void FramelessHelper::setShadowEnabled(QObject *const obj, const bool val) {
+    if (!obj) {
+        return;
+    }
+    m_shadows[obj].enabled = val;
+    updateOuterMargin(obj);
+}
+
+int FramelessHelper::getShadowRadius(QObject *const obj) const {
+    if (!obj) {
+        return m_defaultShadowRadius;
+    }
+    return m_shadows.value(obj).radius;
+}
+
+void FramelessHelper::setShadowRadius(QObject *const obj, const int val) {
+    if (!obj || (val <= 0)) {
+        return;
+    }
+    m_shadows[obj].radius = val;
+    updateOuterMargin(obj);
+}
+
+QColor FramelessHelper::getShadowColor(QObject *const obj) const {
+    if (!obj) {
+        return QColor::fromRgba(m_defaultShadowColor);
+    }
+    return m_shadows.value(obj).color;
+}
+
+void FramelessHelper::setShadowColor(QObject *const obj, const QColor &val) {
+    if (!obj || !val.isValid()) {
+        return;
+    }
+    m_shadows[obj].color = val;
+    updateOuterMargin(obj);
+}
+
+int FramelessHelper::getOuterMargin(QObject *const obj) const {
+    const SHADOW shadow = m_shadows.value(obj);
+    if (shadow.enabled) {
+        return shadow.radius;
+    }
+    return getResizeBorderOutside(obj)
+        ? qMax(getEffectiveBorderWidth(obj), getEffectiveBorderHeight(obj))
+        : 0;
+}
+
+void FramelessHelper::updateOuterMargin(QObject *const obj) {
+#ifdef QT_WIDGETS_LIB
+    if (obj->isWidgetType()) {
+        const auto widget = qobject_cast<QWidget *>(obj);
+        if (widget) {
+            const int margin = getOuterMargin(obj);
+            const int appliedMargin = m_shadows.value(obj).appliedMargin;
+            if (margin == appliedMargin) {
+                // Only the look of the shadow changed, if anything.
+                if (getShadowEnabled(obj)) {
+                    widget->update();
+                }
+                return;
+            }
+            m_shadows[obj].appliedMargin = margin;
+            // The shadow is drawn into the transparent margin around the
+            // content, which also becomes part of the resize area.
+            if ((margin > 0) != (appliedMargin > 0)) {
+                if ((margin > 0) &&
+                    widget->testAttribute(Qt::WA_WState_Created)) {
+                    qWarning().noquote()
+                        << "The client-side shadow or the outside resize "
+                           "border has been enabled after the native window "
+                           "was created, the margin won't be transparent "
+                           "unless the window system gave it an alpha "
+                           "channel already. Enable them before the window "
+                           "is shown.";
+                }
+                widget->setAttribute(Qt::WA_TranslucentBackground, margin > 0);
+            }
+            widget->setContentsMargins(margin, margin, margin, margin);
+            updateMask(obj);
+            updateInputShape(obj);
+            widget->update();
+        }
+        return;
+    }
+#endif
+    if (getShadowEnabled(obj) || getResizeBorderOutside(obj)) {
+        qWarning().noquote() << "The client-side shadow and the outside "
+                                "resize border are only supported for "
+                                "QWidget based windows.";
+    }
+}
+
+void FramelessHelper::paintShadow(QObject *const obj) {
+#ifdef QT_WIDGETS_LIB
+    const auto widget = qobject_cast<QWidget *>(obj);
+    if (!widget) {
+        return;
+    }
+    const SHADOW shadow = m_shadows.value(obj);
+    const QRect content = widget->rect().marginsRemoved(
+        {shadow.radius, shadow.radius, shadow.radius, shadow.radius});
+    QPainter painter(widget);
+    drawShadow(&painter, widget->rect(), shadow.radius,
+               getShadowPixmap(shadow.radius, shadow.color,
+                               widget->devicePixelRatioF()));
+    const int cornerRadius = getCornerRadius(obj);
+    if (cornerRadius > 0) {
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(widget->palette().brush(widget->backgroundRole()));
+        painter.drawRoundedRect(content, cornerRadius, cornerRadius);
+    } else {
+        painter.fillRect(content,
+                         widget->palette().brush(widget->backgroundRole()));
+    }
+#else
+    Q_UNUSED(obj)
+#endif
+}
+
+int FramelessHelper::getCornerRadius(QObject *const obj) const {
+    if (!obj) {
+        return 0;
+    }
+    return m_roundedCorners.value(obj).radius;
+}
+
+void FramelessHelper::setCornerRadius(QObject *const obj, const int val) {
+    if (!obj || (val < 0)) {
+        return;
+    }
+    m_roundedCorners[obj].radius = val;
+    updateMask(obj);
+#ifdef QT_WIDGETS_LIB
+    if (getShadowEnabled(obj)) {
+        const auto widget = qobject_cast<QWidget *>(obj);
+        if (widget) {
+            widget->update();
+        }
+    }
+#endif
+}
+
+void FramelessHelper::updateMask(QObject *const obj) {
+    const auto it = m_roundedCorners.find(obj);
+    if (it == m_roundedCorners.end()) {
+        return;
+    }
+    it->maskPending = false;
+    // The shadow would be cut off, the corners are painted in this case.
+    const bool rounded = (it->radius > 0) && !getShadowEnabled(obj);
+    if (obj->isWindowType()) {
+        const auto window = qobject_cast<QWindow *>(obj);
+        if (window) {
+            window->setMask(rounded ? getRoundedMask(window->size(), it->radius)
+                                    : QRegion());
+        }
+    }
+#ifdef QT_WIDGETS_LIB
+    else if (obj->isWidgetType()) {
+        const auto widget = qobject_cast<QWidget *>(obj);
+        if (widget) {
+            if (rounded) {
+                widget->setMask(getRoundedMask(widget->size(), it->radius));
+            } else {
+                widget->clearMask();
+            }
+        }
+    }
+#endif
+}
+
+QColor FramelessHelper::getBackgroundColor(QObject *const obj) const {
+    if (!obj) {
+        return {};
+    }
+    return m_backgroundColors.value(obj);
+}
+
+void FramelessHelper::setBackgroundColor(QObject *const obj,
+                                         const QColor &val) {
+    if (!obj || !val.isValid()) {
+        return;
+    }
+    m_backgroundColors[obj] = val;
+    if (obj->isWindowType()) {
+#ifdef QT_QUICK_LIB
+        const auto quickWindow = qobject_cast<QQuickWindow *>(obj);
+        if (quickWindow) {
+            // The clear colour of the scene graph, it's what the user sees
+            // until the first frame of the new size has been rendered.
+            quickWindow->setColor(val);
+            return;
+        }
+#endif
+        qWarning().noquote() << "Can't set the background color of" << obj
+                             << ": only QQuickWindow and QWidget are "
+                                "supported.";
+    }
+#ifdef QT_WIDGETS_LIB
+    else if (obj->isWidgetType()) {
+        const auto widget = qobject_cast<QWidget *>(obj);
+        if (widget) {
+            // The backing store fills the newly exposed area with the
+            // background brush before anything else is painted there.
+            QPalette palette = widget->palette();
+            palette.setColor(widget->backgroundRole(), val);
+            widget->setPalette(palette);
+            widget->setAutoFillBackground(true);
+        }
+    }
+#endif
+}
+
+bool FramelessHelper::getSnapEnabled(QObject *const obj) const {
+    if (!obj) {
+        return false;
+    }
+    return m_snapEnabled.value(obj);
+}
+
+void FramelessHelper::setSnapEnabled(QObject *const obj, const bool val) {
+    if (obj) {
+        m_snapEnabled[obj] = val;
+    }
+}
+
+bool FramelessHelper::getNativeEventFilterEnabled() const {
+    return m_nativeEventFilter != nullptr;
+}
+
+void FramelessHelper::setNativeEventFilterEnabled(const bool val) {
+    if (val == getNativeEventFilterEnabled()) {
+        return;
+    }
+    if (val) {
+        if (!X11NativeEventFilter::isPlatformX11()) {
+            qWarning().noquote() << "The native event filter is only "
+                                    "available on X11.";
+            return;
+        }
+        m_nativeEventFilter = new X11NativeEventFilter(this);
+        QCoreApplication::instance()->installNativeEventFilter(
+            m_nativeEventFilter);
+    } else {
+        QCoreApplication::instance()->removeNativeEventFilter(
+            m_nativeEventFilter);
+        delete m_nativeEventFilter;
+        m_nativeEventFilter = nullptr;
+    }
+}
+
+bool FramelessHelper::getMouseTransparent(QObject *const obj) const {
+    if (!obj) {
+        return false;
+    }
+    return m_inputShapes.value(obj).transparent;
+}
+
+void FramelessHelper::setMouseTransparent(QObject *const obj, const bool val) {
+    if (obj) {
+        m_inputShapes[obj].transparent = val;
+        updateInputShape(obj);
+    }
+}
+
+QVector<QRect>
+FramelessHelper::getMouseTransparentAreas(QObject *const obj) const {
+    if (!obj) {
+        return {};
+    }
+    return m_inputShapes.value(obj).transparentAreas;
+}
+
+void FramelessHelper::setMouseTransparentAreas(QObject *const obj,
+                                               const QVector<QRect> &val) {
+    if (obj) {
+        m_inputShapes[obj].transparentAreas = val;
+        updateInputShape(obj);
+    }
+}
+
+bool FramelessHelper::getResizeBorderOutside(QObject *const obj) const {
+    if (!obj) {
+        return false;
+    }
+    return m_inputShapes.value(obj).resizeBorderOutside;
+}
+
+void FramelessHelper::setResizeBorderOutside(QObject *const obj,
+                                             const bool val) {
+    if (obj) {
+        m_inputShapes[obj].resizeBorderOutside = val;
+        updateOuterMargin(obj);
+        updateInputShape(obj);
+    }
+}
+
+void FramelessHelper::updateInputShape(QObject *const obj) {
+    const auto it = m_inputShapes.find(obj);
+    if (it == m_inputShapes.end()) {
+        return;
+    }
+    it->updatePending = false;
+    QWindow *const window = getWindowHandle(obj);
+    if (!window) {
+        // Applied once the native window exists, see the Show event.
+        return;
+    }
+    const QRect rect = {{0, 0}, window->size()};
+    QRegion region = {};
+    if (!it->transparent) {
+        region = rect;
+        if (it->resizeBorderOutside) {
+            // Only the resize border around the content gets the mouse,
+            // anything else of the transparent margin is click-through.
+            const int margin = getOuterMargin(obj);
+            const int borderWidth = getEffectiveBorderWidth(obj);
+            const int borderHeight = getEffectiveBorderHeight(obj);
+            region = rect.marginsRemoved({qMax(0, margin - borderWidth),
+                                          qMax(0, margin - borderHeight),
+                                          qMax(0, margin - borderWidth),
+                                          qMax(0, margin - borderHeight)});
+        }
+        for (auto &&area : qAsConst(it->transparentAreas)) {
+            region -= area;
+        }
+    }
+    // Don't bother the X server if nothing changed.
+    if (it->applied && (region == it->region)) {
+        return;
+    }
+    it->applied = true;
+    it->region = region;
+    if (X11NativeEventFilter::setInputShape(window, region)) {
+        return;
+    }
+    // Without XShape, only the whole window can be made click-through. The
+    // region changes with every resize, don't repeat ourselves.
+    if ((!it->transparentAreas.isEmpty() || it->resizeBorderOutside) &&
+        !it->warned) {
+        it->warned = true;
+        qWarning().noquote() << "Mouse transparent areas are only supported "
+                                "on X11.";
+    }
+#ifdef QT_WIDGETS_LIB
+    if (obj->isWidgetType()) {
+        const auto widget = qobject_cast<QWidget *>(obj);
+        if (widget) {
+            Qt::WindowFlags flags = widget->windowFlags();
+            if (flags.testFlag(Qt::WindowTransparentForInput) !=
+                it->transparent) {
+                // QWidget::setWindowFlag() destroys, recreates and hides the
+                // native window. Only let the widget know, so that it keeps
+                // the flag if it creates a new native window, and change the
+                // existing one in place below.
+                flags.setFlag(Qt::WindowTransparentForInput, it->transparent);
+                widget->overrideWindowFlags(flags);
+            }
+        }
+    }
+#endif
+    // Reconfigures the platform window, it's not recreated.
+    const bool transparent =
+        window->flags().testFlag(Qt::WindowTransparentForInput);
+    if (transparent != it->transparent) {
+        window->setFlag(Qt::WindowTransparentForInput, it->transparent);
+    }
+}
+
+bool FramelessHelper::getSystemBordersEnabled(QObject *const obj) const {
+    if (!obj) {
+        return false;
+    }
+    return m_systemBorders.value(obj);
+}
+
+void FramelessHelper::setSystemBordersEnabled(QObject *const obj,
+                                              const bool val) {
+    if (!obj) {
+        return;
+    }
+    if (val && !X11NativeEventFilter::isPlatformX11()) {
+        qWarning().noquote() << "The system resize borders are only "
+                                "available on X11, the window will be "
+                                "frameless.";
+        return;
+    }
+    m_systemBorders[obj] = val;
+}
+
+void FramelessHelper::setRegionChannel(QObject *const obj,
+                                       QObject *const container,
+                                       const QString &key) {
+    if (!obj || !container || key.isEmpty()) {
+        return;
+    }
+    REGIONCHANNEL &regionChannel = m_regionChannels[obj];
+    regionChannel.container = container;
+    if (!regionChannel.channel || (regionChannel.channel->getKey() != key)) {
+        regionChannel.channel =
+            QSharedPointer<FramelessRegionChannel>::create(key);
+    }
+}
+
+void FramelessHelper::clearRegionChannel(QObject *const obj) {
+    if (obj) {
+        m_regionChannels.remove(obj);
+    }
+}
+
+FramelessRegionChannel::REGIONS
+FramelessHelper::getChannelRegions(QObject *const obj) const {
+    const auto it = m_regionChannels.constFind(obj);
+    if ((it == m_regionChannels.constEnd()) || !it->channel) {
+        return {};
+    }
+    const QRect geometry = getEmbeddedGeometry(it->container);
+    if (!geometry.isValid()) {
+        return {};
+    }
+    // Lock-free, nothing is copied if the regions didn't change.
+    FramelessRegionChannel::REGIONS regions = it->channel->read();
+    const auto map = [&geometry](QVector<QRect> &areas) {
+        for (auto &&area : areas) {
+            area = area.translated(geometry.topLeft()).intersected(geometry);
+        }
+    };
+    map(regions.draggableAreas);
+    map(regions.ignoreAreas);
+    return regions;
+}
+
+void FramelessHelper::applySystemBorders(QObject *const obj) {
+    // Qt writes it's own _MOTIF_WM_HINTS when it creates the native window,
+    // so this is done again when the window is shown. Qt only amends the
+    // functions when it maps the window, the decorations are kept.
+    QWindow *const window = getWindowHandle(obj);
+    if (window) {
+        X11NativeEventFilter::setBordersOnly(window);
+    }
+}
+
+void FramelessHelper::removeObjectState(QObject *const obj) {
+    m_framelessObjects.removeAll(obj);
+    m_ignoreAreas.remove(obj);
+    m_draggableAreas.remove(obj);
+    m_ignoreObjects.remove(obj);
+    m_draggableObjects.remove(obj);
+    m_fixedSize.remove(obj);
+    m_disableTitleBar.remove(obj);
+    m_outlineResize.remove(obj);
+    m_snapEnabled.remove(obj);
+    m_systemBorders.remove(obj);
+    // The outline is a top level window of its own, nobody else deletes it.
+    const MANUALGRAB grab = m_manualGrabs.take(obj);
+    if (grab.outline) {
+        delete grab.outline;
+    }
+    // The settle timer deletes itself, see startLiveResize().
+    m_liveResizes.remove(obj);
+    m_shadows.remove(obj);
+    m_roundedCorners.remove(obj);
+    m_touchGestures.remove(obj);
+    m_inputShapes.remove(obj);
+    m_pendingMoves.remove(obj);
+    m_regionChannels.remove(obj);
+    m_backgroundColors.remove(obj);
+}
+
+void FramelessHelper::removeWindowFrame(QObject *const obj) {
+    if (obj) {
+        if (!m_framelessObjects.contains(obj)) {
+            m_framelessObjects.append(obj);
+            connect(obj, &QObject::destroyed, this,
+                    [this, obj]() { removeObjectState(obj); });
+        }
+        // In the hybrid mode the window keeps it's system frame, we only
+        // ask the window manager to drop the title bar, see
+        // applySystemBorders().
+        const bool hybrid = getSystemBordersEnabled(obj);
+        if (hybrid) {
+            applySystemBorders(obj);
+        }
+        // Don't miss the Qt::Window flag.
+        const Qt::WindowFlags flags = hybrid
+            ? Qt::WindowFlags(Qt::Window)
+            : (Qt::Window | Qt::FramelessWindowHint);
+        const auto window = qobject_cast<QWindow *>(obj);
+        if (window) {
+            // Changing the flags of a window which has a platform window
+            // already makes Qt reconfigure (and the window manager redecorate)
+            // the native window, and the user can see the system frame for a
+            // short time. Don't touch the flags if they are already correct.
+            if (window->flags() != flags) {
+                if (window->handle()) {
+                    reportLateFlagChange(obj);
+                }
+                window->setFlags(flags);
+            }
+            // MouseTracking is always enabled for QWindow.
+            window->installEventFilter(this);
+        }
+#ifdef QT_WIDGETS_LIB
+        else {
+            const auto widget = qobject_cast<QWidget *>(obj);
+            if (widget && widget->isTopLevel()) {
+                // QWidget::setWindowFlags() destroys and recreates the native
+                // window if it has been created already.
+                if (widget->windowFlags() != flags) {
+                    if (widget->testAttribute(Qt::WA_WState_Created)) {
+                        reportLateFlagChange(obj);
+                    }
+                    widget->setWindowFlags(flags);
+                }
+                // The mouse events are filtered on the native window, which
+                // gets all the mouse moves, so the mouse tracking of the
+                // widget can stay disabled. Watched once it's created, see
+                // the QEvent::WinIdChange of eventFilter().
+                widget->installEventFilter(this);
+                watchNativeWindow(obj);
+                updateQtFrame(widget->windowHandle(),
+                              getEffectiveTitleBarHeight(obj));
+            }
+        }
+#endif
+    }
+}
+
+void FramelessHelper::startManualGrab(QObject *const obj,
+                                      const Qt::Edges edges,
+                                      const QPointF &globalPoint) {
+    if (!obj) {
+        return;
+    }
+    MANUALGRAB &grab = m_manualGrabs[obj];
+    grab.active = true;
+    grab.updatePending = false;
+    grab.edges = edges;
+    grab.pressPos = globalPoint.toPoint();
+    grab.startGeometry = getWindowGeometry(obj);
+    grab.pendingGeometry = grab.startGeometry;
+    grab.snapZone = {};
+    grab.outlineOnly = (edges != Qt::Edges{}) && getOutlineResizeEnabled(obj);
+    if (grab.outlineOnly) {
+        if (!grab.outline) {
+            grab.outline = new OutlineWindow(getWindowScreen(obj));
+        }
+        grab.outline->setGeometry(grab.startGeometry);
+        grab.outline->show();
+    }
+    grab.snapLinesX.clear();
+    grab.snapLinesY.clear();
+    grab.snapScreens.clear();
+    grab.snapAvailableGeometries.clear();
+    if ((edges == Qt::Edges{}) && getSnapEnabled(obj)) {
+        // Everything the window can snap to is collected once, so a motion
+        // event only costs two binary searches per axis.
+        const auto screens = QGuiApplication::screens();
+        for (auto &&screen : qAsConst(screens)) {
+            const SCREENINFO &info = getScreenInfo(screen);
+            const QRect rect = info.availableGeometry;
+            grab.snapLinesX << rect.left() << (rect.right() + 1);
+            grab.snapLinesY << rect.top() << (rect.bottom() + 1);
+            grab.snapScreens.append(info.geometry);
+            grab.snapAvailableGeometries.append(rect);
+        }
+        QWindow *const self = getWindowHandle(obj);
+        const auto windows = QGuiApplication::topLevelWindows();
+        for (auto &&window : qAsConst(windows)) {
+            if ((window == self) || !window->isVisible() ||
+                (window->type() != Qt::Window) ||
+                (window->windowStates() != Qt::WindowNoState)) {
+                continue;
+            }
+            const QRect rect = window->frameGeometry();
+            grab.snapLinesX << rect.left() << (rect.right() + 1);
+            grab.snapLinesY << rect.top() << (rect.bottom() + 1);
+        }
+        std::sort(grab.snapLinesX.begin(), grab.snapLinesX.end());
+        std::sort(grab.snapLinesY.begin(), grab.snapLinesY.end());
+    }
+}
+
+void FramelessHelper::updateManualGrab(QObject *const obj,
+                                       const QPointF &globalPoint) {
+    const auto it = m_manualGrabs.find(obj);
+    if ((it == m_manualGrabs.end()) || !it->active) {
+        return;
+    }
+    const QPoint delta = globalPoint.toPoint() - it->pressPos;
+    const QRect start = it->startGeometry;
+    QRect geometry = start;
+    if (it->edges == Qt::Edges{}) {
+        geometry.moveTopLeft(start.topLeft() + delta);
+        if (!it->snapScreens.isEmpty()) {
+            geometry.translate(getSnapOffset(it->snapLinesX, geometry.left(),
+                                             geometry.right() + 1),
+                               getSnapOffset(it->snapLinesY, geometry.top(),
+                                             geometry.bottom() + 1));
+            it->snapZone =
+                getSnapZone(it->snapScreens, it->snapAvailableGeometries,
+                            globalPoint.toPoint());
+        }
+    } else {
+        const QSize size = getBoundedWindowSize(
+            obj,
+            {start.width() +
+                 (it->edges.testFlag(Qt::Edge::LeftEdge)
+                      ? -delta.x()
+                      : (it->edges.testFlag(Qt::Edge::RightEdge) ? delta.x()
+                                                                 : 0)),
+             start.height() +
+                 (it->edges.testFlag(Qt::Edge::TopEdge)
+                      ? -delta.y()
+                      : (it->edges.testFlag(Qt::Edge::BottomEdge) ? delta.y()
+                                                                  : 0))});
+        // Keep the opposite edges where they are.
+        geometry.setSize(size);
+        if (it->edges.testFlag(Qt::Edge::LeftEdge)) {
+            geometry.moveRight(start.right());
+        }
+        if (it->edges.testFlag(Qt::Edge::TopEdge)) {
+            geometry.moveBottom(start.bottom());
+        }
+    }
+    it->pendingGeometry = geometry;
+    // Motion compression: no matter how many motion events we get, the
+    // geometry is changed at most once per frame.
+    if (!it->updatePending) {
+        it->updatePending = true;
+        requestFrameUpdate(obj);
+    }
+}
+
+void FramelessHelper::stopManualGrab(QObject *const obj) {
+    const auto it = m_manualGrabs.find(obj);
+    if ((it == m_manualGrabs.end()) || !it->active) {
+        return;
+    }
+    it->active = false;
+    if (it->outline) {
+        delete it->outline;
+    }
+    if (it->snapZone.isValid()) {
+        it->updatePending = false;
+        setWindowGeometry(obj, it->snapZone, false);
+    } else if (it->outlineOnly) {
+        // Commit the geometry only once.
+        it->updatePending = false;
+        if (it->pendingGeometry != it->startGeometry) {
+            setWindowGeometry(obj, it->pendingGeometry, false);
+        }
+    } else if (it->updatePending) {
+        it->updatePending = false;
+        setWindowGeometry(obj, it->pendingGeometry, false);
+    }
+}
+
+void FramelessHelper::startLiveResize(QObject *const obj) {
+#ifdef QT_WIDGETS_LIB
+    auto it = m_liveResizes.find(obj);
+    if ((it == m_liveResizes.end()) || !it->enabled || it->active ||
+        !obj->isWidgetType()) {
+        return;
+    }
+    const auto widget = qobject_cast<QWidget *>(obj);
+    if (!widget) {
+        return;
+    }
+    // The backing store doesn't keep the previous frame across a resize, so
+    // keep a copy of our own. Grab before the session is marked active, the
+    // paint events of grab() must not be swallowed.
+    const QPixmap lastFrame = widget->grab();
+    it = m_liveResizes.find(obj);
+    it->lastFrame = lastFrame;
+    it->active = true;
+    it->resizePending = false;
+    it->laidOutSize = widget->size();
+    it->frameTimer.start();
+    // QLayout reacts to the resize events of the widget before any event
+    // filter sees them, so the only way to hold it back is to disable it.
+    // Leave layouts the user disabled alone.
+    QLayout *const layout = widget->layout();
+    if (layout && layout->isEnabled()) {
+        layout->setEnabled(false);
+        it->layout = layout;
+    } else {
+        it->layout = nullptr;
+    }
+    if (!it->settleTimer) {
+        it->settleTimer = new QTimer(this);
+        it->settleTimer->setSingleShot(true);
+        it->settleTimer->setInterval(m_liveResizeSettleDelay);
+        connect(it->settleTimer, &QTimer::timeout, this,
+                [this, obj]() { stopLiveResize(obj); });
+        connect(obj, &QObject::destroyed, it->settleTimer,
+                &QObject::deleteLater);
+    }
+    it->settleTimer->start();
+#else
+    Q_UNUSED(obj)
+#endif
+}
+
+void FramelessHelper::stopLiveResize(QObject *const obj) {
+#ifdef QT_WIDGETS_LIB
+    const auto it = m_liveResizes.find(obj);
+    if ((it == m_liveResizes.end()) || !it->active) {
+        return;
+    }
+    if (it->settleTimer) {
+        it->settleTimer->stop();
+    }
+    it->active = false;
+    it->resizePending = false;
+    it->lastFrame = {};
+    // The final size: give the layout back and repaint everything once.
+    if (it->layout) {
+        it->layout->setEnabled(true);
+        it->layout->invalidate();
+        it->layout->activate();
+        it->layout = nullptr;
+    }
+    const auto widget = qobject_cast<QWidget *>(obj);
+    if (widget) {
+        it->laidOutSize = widget->size();
+        widget->update();
+    }
+#else
+    Q_UNUSED(obj)
+#endif
+}
+
+void FramelessHelper::deliverLiveResize(QObject *const obj) {
+#ifdef QT_WIDGETS_LIB
+    const auto it = m_liveResizes.find(obj);
+    if ((it == m_liveResizes.end()) || !it->active || !it->resizePending) {
+        return;
+    }
+    const auto widget = qobject_cast<QWidget *>(obj);
+    if (!widget) {
+        return;
+    }
+    it->resizePending = false;
+    // One layout pass for this frame. A disabled layout can't be activated
+    // and an activated one ignores activate() until it's invalidated.
+    if (it->layout) {
+        it->layout->setEnabled(true);
+        it->layout->invalidate();
+        it->layout->activate();
+        it->layout->setEnabled(false);
+    }
+    it->laidOutSize = widget->size();
+    it->frameTimer.start();
+    widget->update();
+#else
+    Q_UNUSED(obj)
+#endif
+}
+
+bool FramelessHelper::filterLiveResizeEvent(QObject *const obj,
+                                            QEvent *const event) {
+#ifdef QT_WIDGETS_LIB
+    auto it = m_liveResizes.find(obj);
+    if ((it == m_liveResizes.end()) || !it->enabled ||
+        !obj->isWidgetType()) {
+        return false;
+    }
+    if (event->type() == QEvent::Resize) {
+        if (!it->active) {
+            // A burst of resize events is a live resize as well, even if
+            // we didn't start it (the window manager or a keyboard resize).
+            const bool burst = it->burstTimer.isValid() &&
+                !it->burstTimer.hasExpired(m_liveResizeBurstInterval);
+            it->burstTimer.start();
+            if (!burst) {
+                return false;
+            }
+            startLiveResize(obj);
+            it = m_liveResizes.find(obj);
+            if (!it->active) {
+                return false;
+            }
+        }
+        it->settleTimer->start();
+        it->resizePending = true;
+        if (it->frameTimer.hasExpired(m_liveResizeFrameBudget)) {
+            deliverLiveResize(obj);
+        } else {
+            // Try again in the next frame.
+            requestFrameUpdate(obj);
+        }
+        // The disabled layout ignores it, the widget itself still needs it.
+        return false;
+    }
+    if ((event->type() == QEvent::Paint) && it->active && it->resizePending &&
+        !it->lastFrame.isNull()) {
+        // The layout is out of date, don't waste time on painting the
+        // widget itself. Draw the frame from the start of the session
+        // unscaled and pad the newly exposed area with the background
+        // colour, the children still paint themselves.
+        const auto widget = qobject_cast<QWidget *>(obj);
+        if (widget) {
+            const qreal frameRatio = it->lastFrame.devicePixelRatio();
+            const QRect frameRect = {{0, 0},
+                                     it->lastFrame.size() / frameRatio};
+            QPainter painter(widget);
+            painter.drawPixmap(frameRect.topLeft(), it->lastFrame);
+            const QRegion exposed =
+                QRegion(widget->rect()).subtracted(frameRect);
+            if (!exposed.isEmpty()) {
+                painter.setClipRegion(exposed, Qt::IntersectClip);
+                painter.fillRect(widget->rect(),
+                                 widget->palette().brush(
+                                     widget->backgroundRole()));
+            }
+            return true;
+        }
+    }
+    return false;
+#else
+    Q_UNUSED(obj)
+    Q_UNUSED(event)
+    return false;
+#endif
+}
+
+void FramelessHelper::requestFrameUpdate(QObject *const obj) {
+    QWindow *const window = getWindowHandle(obj);
+    if (!window) {
+        processFrameUpdate(obj);
+        return;
+    }
+    // QWidget doesn't receive the QEvent::UpdateRequest of it's native
+    // window, so we have to watch the native window as well.
+    watchNativeWindow(obj);
+    window->requestUpdate();
+}
+
+void FramelessHelper::watchNativeWindow(QObject *const obj) {
+    QWindow *const window = getWindowHandle(obj);
+    if (!window || (window == obj) || m_windowOwners.contains(window)) {
+        return;
+    }
+    m_windowOwners.insert(window, obj);
+    window->installEventFilter(this);
+    connect(window, &QObject::destroyed, this,
+            [this, window]() { m_windowOwners.remove(window); });
+}
+
+void FramelessHelper::processFrameUpdate(QObject *const obj) {
+    // Before the manual grab, so that it's new geometry is applied in this
+    // frame already.
+    flushMouseMove(obj);
+    const auto it = m_manualGrabs.find(obj);
+    if ((it != m_manualGrabs.end()) && it->updatePending) {
+        it->updatePending = false;
+        if (it->outlineOnly) {
+            if (it->outline) {
+                it->outline->setGeometry(it->pendingGeometry);
+            }
+        } else {
+            setWindowGeometry(obj, it->pendingGeometry, false);
+            // Preview of the half or quarter the window will be tiled to.
+            if (it->snapZone.isValid()) {
+                if (!it->outline) {
+                    it->outline = new OutlineWindow(getWindowScreen(obj));
+                }
+                it->outline->setGeometry(it->snapZone);
+                it->outline->show();
+            } else if (it->outline) {
+                it->outline->hide();
+            }
+        }
+    }
+    const auto gesture = m_touchGestures.find(obj);
+    if ((gesture != m_touchGestures.end()) && gesture->updatePending) {
+        gesture->updatePending = false;
+        setWindowGeometry(obj, gesture->pendingGeometry, false);
+    }
+    if (m_roundedCorners.value(obj).maskPending) {
+        updateMask(obj);
+    }
+    if (m_inputShapes.value(obj).updatePending) {
+        updateInputShape(obj);
+    }
+    const auto liveResize = m_liveResizes.constFind(obj);
+    if ((liveResize != m_liveResizes.constEnd()) && liveResize->active &&
+        liveResize->resizePending) {
+        if (liveResize->frameTimer.hasExpired(m_liveResizeFrameBudget)) {
+            deliverLiveResize(obj);
+        } else {
+            requestFrameUpdate(obj);
+        }
+    }
+}
+
+void FramelessHelper::flushMouseMove(QObject *const obj) {
+    const auto it = m_pendingMoves.find(obj);
+    if ((it == m_pendingMoves.end()) || !it->pending) {
+        return;
+    }
+    it->pending = false;
+    ++m_handledMouseMoves;
+    // Copy, the hash may change below.
+    const QPointF windowPos = it->windowPos, screenPos = it->screenPos;
+    if (m_manualGrabs.value(obj).active) {
+        updateManualGrab(obj, screenPos);
+    } else {
+        updateCursor(obj, windowPos);
+    }
+}
+
+void FramelessHelper::queueMouseMove(QObject *const obj,
+                                     const QPointF &windowPos,
+                                     const QPointF &screenPos) {
+    // High rate pointers report far more moves than we can handle, only the
+    // latest one of each window is handled.
+    PENDINGMOVE &move = m_pendingMoves[obj];
+    if (move.pending) {
+        ++m_coalescedMouseMoves;
+    }
+    move.pending = true;
+    move.windowPos = windowPos;
+    move.screenPos = screenPos;
+    // Once per pass of the event loop, after all the moves the window system
+    // had for us. Not with a frame update: it would make the window render
+    // (or sync the backing store of the widget) for every mouse move.
+    if (!m_mouseMovesQueued) {
+        m_mouseMovesQueued = true;
+        QMetaObject::invokeMethod(this, &FramelessHelper::flushMouseMoves,
+                                  Qt::QueuedConnection);
+    }
+}
+
+void FramelessHelper::flushMouseMoves() {
+    m_mouseMovesQueued = false;
+    const auto objs = m_pendingMoves.keys();
+    for (auto &&obj : qAsConst(objs)) {
+        flushMouseMove(obj);
+    }
+}
+
+Qt::Edges FramelessHelper::getWindowEdges(QObject *const obj,
+                                          const QPointF &point, const int ww,
+                                          const int wh) const {
+    if (getSystemBordersEnabled(obj)) {
+        // The window manager draws and handles the resize borders.
+        return {};
+    }
+    // The transparent margin around the content belongs to the resize area
+    // as well. If the resize border is outside, it's all the resize area
+    // (the input shape makes the rest of it click-through).
+    const int outerMargin = getOuterMargin(obj);
+    const bool outside = getResizeBorderOutside(obj);
+    const int borderWidth =
+        outside ? outerMargin : getEffectiveBorderWidth(obj) + outerMargin;
+    const int borderHeight =
+        outside ? outerMargin : getEffectiveBorderHeight(obj) + outerMargin;
+    if (point.y() <= borderHeight) {
+        if (point.x() <= borderWidth) {
+            return Qt::Edge::TopEdge | Qt::Edge::LeftEdge;
+        }
+        if (point.x() >= (ww - borderWidth)) {
+            return Qt::Edge::TopEdge | Qt::Edge::RightEdge;
+        }
+        return Qt::Edge::TopEdge;
+    }
+    if (point.y() >= (wh - borderHeight)) {
+        if (point.x() <= borderWidth) {
+            return Qt::Edge::BottomEdge | Qt::Edge::LeftEdge;
+        }
+        if (point.x() >= (ww - borderWidth)) {
+            return Qt::Edge::BottomEdge | Qt::Edge::RightEdge;
+        }
+        return Qt::Edge::BottomEdge;
+    }
+    if (point.x() <= borderWidth) {
+        return Qt::Edge::LeftEdge;
+    }
+    if (point.x() >= (ww - borderWidth)) {
+        return Qt::Edge::RightEdge;
+    }
+    return {};
+}
+
+bool FramelessHelper::isInSpecificObjects(const QPointF &globalPoint,
+                                          const QVector<QObject *> &objects) {
+#if defined(QT_WIDGETS_LIB) || defined(QT_QUICK_LIB)
+    if (objects.isEmpty()) {
+        return false;
+    }
+    const int x = globalPoint.x(), y = globalPoint.y();
+    for (auto &&obj : qAsConst(objects)) {
+        if (!obj) {
+            continue;
+        }
+#ifdef QT_WIDGETS_LIB
+        const auto widget = qobject_cast<QWidget *>(obj);
+        if (widget) {
+            const QPoint pos = widget->mapToGlobal({0, 0});
+            const QRect geometry = {pos.x(), pos.y(), widget->width(),
+                                    widget->height()};
+            if (geometry.contains(x, y)) {
+                // The widget stores its mask as a region already.
+                const QRegion mask = widget->mask();
+                if (mask.isEmpty() || mask.contains(QPoint(x, y) - pos)) {
+                    return true;
+                }
+            }
+        }
+#endif
+#ifdef QT_QUICK_LIB
+        const auto quickItem = qobject_cast<QQuickItem *>(obj);
+        if (quickItem) {
+            const QPointF pos = quickItem->mapToGlobal({0, 0});
+            const QRectF geometry = {pos.x(), pos.y(), quickItem->width(),
+                                     quickItem->height()};
+            if (geometry.contains(x, y)) {
+                // QQuickItem::contains() honours containmentMask. It may be
+                // implemented in JavaScript and depend on any state of the
+                // item, so it's asked for the hit point only and its result
+                // is never cached.
+                if (quickItem->contains(
+                        quickItem->mapFromGlobal(QPointF(x, y)))) {
+                    return true;
+                }
+            }
+        }
+#endif
+    }
+    return false;
+#else
+    Q_UNUSED(globalPoint)
+    Q_UNUSED(objects)
+    return false;
+#endif
+}
+
+bool FramelessHelper::isResizePermitted(const QPointF &globalPoint,
+                                        const QPointF &point,
+                                        QObject *const obj) {
+    if (!obj) {
+        return false;
     }
+    return (!isInSpecificAreas(point, getIgnoreAreas(obj)) &&
+            !isInSpecificAreas(point, getChannelRegions(obj).ignoreAreas) &&
+            !isInSpecificObjects(globalPoint, getIgnoreObjects(obj)));
 }
 
-QVector<QObject *> FramelessHelper::getIgnoreObjects(QObject *const obj) const {
+bool FramelessHelper::isInTitlebarArea(const QPointF &globalPoint,
+                                       const QPointF &point,
+                                       QObject *const obj) {
     if (!obj) {
-        return {};
+        return false;
     }
-    QVector<QObject *> ret{};
-    const QVector<QPointer<QObject>> objs = m_ignoreObjects.value(obj);
-    if (!objs.isEmpty()) {
-        for (auto &&_obj : qAsConst(objs)) {
-            if (_obj) {
-                ret.append(_obj);
-            }
-        }
+    // An embedded window knows where it's own title bar is, no matter how
+    // high ours is.
+    if (isInSpecificAreas(point, getChannelRegions(obj).draggableAreas)) {
+        return isResizePermitted(globalPoint, point, obj) &&
+            getTitleBarEnabled(obj);
     }
-    return ret;
+    // No draggable areas or objects means the whole title bar is draggable.
+    const auto areas = getDraggableAreas(obj);
+    const auto objs = getDraggableObjects(obj);
+    return ((point.y() <=
+             (getEffectiveTitleBarHeight(obj) + getOuterMargin(obj))) &&
+            (areas.isEmpty() || isInSpecificAreas(point, areas)) &&
+            (objs.isEmpty() || isInSpecificObjects(globalPoint, objs)) &&
+            isResizePermitted(globalPoint, point, obj) &&
+            !isInInteractiveChild(point, obj) && getTitleBarEnabled(obj));
 }
 
-void FramelessHelper::setIgnoreObjects(QObject *const obj,
-                                       const QVector<QObject *> &val) {
-    if (obj) {
-        QVector<QPointer<QObject>> objs{};
-        if (!val.isEmpty()) {
-            for (auto &&_obj : qAsConst(val)) {
-                objs.append(_obj);
-            }
+bool FramelessHelper::isInInteractiveChild(const QPointF &point,
+                                           QObject *const obj) const {
+#ifdef QT_WIDGETS_LIB
+    if (!obj || !obj->isWidgetType()) {
+        return false;
+    }
+    const auto widget = qobject_cast<QWidget *>(obj);
+    if (!widget) {
+        return false;
+    }
+    // We see the presses on the native window, before the children do. A
+    // child that can take the focus or reacts to hovering (buttons, line
+    // edits and alike) wants the press itself, unless it's one of the
+    // draggable objects.
+    const auto draggableObjects = getDraggableObjects(obj);
+    for (QWidget *child = widget->childAt(point.toPoint());
+         child && (child != widget); child = child->parentWidget()) {
+        if (draggableObjects.contains(child)) {
+            return false;
+        }
+        if ((child->focusPolicy() != Qt::NoFocus) ||
+            child->testAttribute(Qt::WA_Hover)) {
+            return true;
         }
-        m_ignoreObjects[obj] = objs;
     }
+#else
+    Q_UNUSED(point)
+    Q_UNUSED(obj)
+#endif
+    return false;
 }
 
-void FramelessHelper::addIgnoreObject(QObject *const obj, QObject *val) {
-    if (obj) {
-        QVector<QPointer<QObject>> objs = m_ignoreObjects[obj];
-        objs.append(val);
-        m_ignoreObjects[obj] = objs;
+bool FramelessHelper::moveOrResize(const QPointF &globalPoint,
+                                   const QPointF &point, QObject *const obj,
+                                   const bool mouse) {
+    QWindow *const window = getWindowHandle(obj);
+    if (!window) {
+        qWarning().noquote() << "Can't move or resize the window: failed "
+                                "to acquire the window handle.";
+        return false;
     }
-}
-
-void FramelessHelper::clearIgnoreObjects(QObject *const obj) {
-    if (obj) {
-        m_ignoreObjects[obj] = {};
+    const Qt::Edges edges =
+        getWindowEdges(obj, point, window->width(), window->height());
+    // Some window managers and platforms (such as offscreen and minimal)
+    // can't move or resize the window for us, drive it ourselves in this
+    // case.
+    if (edges == Qt::Edges{}) {
+        if (!isInTitlebarArea(globalPoint, point, obj)) {
+            return false;
+        }
+        if (getSnapEnabled(obj)) {
+            // We need every motion event to snap the window.
+            startManualGrab(obj, edges, globalPoint);
+        } else if (!startSystemMoveResize(window, globalPoint, edges,
+                                          mouse)) {
+            startManualGrab(obj, edges, globalPoint);
+        }
+        return true;
     }
-}
-
-QVector<QObject *>
-FramelessHelper::getDraggableObjects(QObject *const obj) const {
-    if (!obj) {
-        return {};
+    if (!window->windowStates().testFlag(Qt::WindowState::WindowNoState) ||
+        !isResizePermitted(globalPoint, point, obj) || !getResizable(obj)) {
+        return false;
     }
-    QVector<QObject *> ret{};
-    const QVector<QPointer<QObject>> objs = m_draggableObjects.value(obj);
-    if (!objs.isEmpty()) {
-        for (auto &&_obj : qAsConst(objs)) {
-            if (_obj) {
-                ret.append(_obj);
-            }
+    if (getOutlineResizeEnabled(obj)) {
+        // Only the outline follows the mouse, the window is resized once on
+        // release.
+        startManualGrab(obj, edges, globalPoint);
+    } else {
+        if (!startSystemMoveResize(window, globalPoint, edges, mouse)) {
+            startManualGrab(obj, edges, globalPoint);
         }
+        startLiveResize(obj);
     }
-    return ret;
+    return true;
 }
 
-void FramelessHelper::setDraggableObjects(QObject *const obj,
-                                          const QVector<QObject *> &val) {
-    if (obj) {
-        QVector<QPointer<QObject>> objs{};
-        if (!val.isEmpty()) {
-            for (auto &&_obj : qAsConst(val)) {
-                objs.append(_obj);
+QObject *FramelessHelper::getFramelessObject(const quintptr windowId,
+                                             QWindow **window) const {
+    for (auto &&obj : qAsConst(m_framelessObjects)) {
+        QWindow *const handle = getWindowHandle(obj);
+        if (handle && (handle->winId() == windowId)) {
+            if (window) {
+                *window = handle;
             }
+            return obj;
         }
-        m_draggableObjects[obj] = objs;
     }
+    return nullptr;
 }
 
-void FramelessHelper::addDraggableObject(QObject *const obj, QObject *val) {
-    if (obj) {
-        QVector<QPointer<QObject>> objs = m_draggableObjects[obj];
-        objs.append(val);
-        m_draggableObjects[obj] = objs;
+void FramelessHelper::updateCursor(QObject *const obj, const QPointF &point) {
+    if (getSystemBordersEnabled(obj)) {
+        return;
     }
-}
-
-void FramelessHelper::clearDraggableObjects(QObject *const obj) {
-    if (obj) {
-        m_draggableObjects[obj] = {};
+    QWindow *const window = getWindowHandle(obj);
+    if (window) {
+        if (window->windowStates().testFlag(Qt::WindowState::WindowNoState) &&
+            getResizable(obj)) {
+            window->setCursor(getCursorShape(getWindowEdges(
+                obj, point, window->width(), window->height())));
+        }
     }
+#ifdef QT_WIDGETS_LIB
+    else {
+        const auto widget = qobject_cast<QWidget *>(obj);
+        if (widget) {
+            if (!widget->isMinimized() && !widget->isMaximized() &&
+                !widget->isFullScreen() && getResizable(obj)) {
+                widget->setCursor(getCursorShape(getWindowEdges(
+                    obj, point, widget->width(), widget->height())));
+            }
+        }
+    }
+#endif
 }
 
-bool FramelessHelper::getResizable(QObject *const obj) const {
-    if (!obj) {
-        return true;
+int FramelessHelper::getEffectiveBorderWidth(QObject *const obj) const {
+    if (m_borderWidth >= 0) {
+        return m_borderWidth;
     }
-    return !m_fixedSize.value(obj);
+    return getScreenInfo(getWindowScreen(obj)).borderWidth;
 }
 
-void FramelessHelper::setResizable(QObject *const obj, const bool val) {
-    if (obj) {
-        m_fixedSize[obj] = !val;
+int FramelessHelper::getEffectiveBorderHeight(QObject *const obj) const {
+    if (m_borderHeight >= 0) {
+        return m_borderHeight;
     }
+    return getScreenInfo(getWindowScreen(obj)).borderHeight;
 }
 
-bool FramelessHelper::getTitleBarEnabled(QObject *const obj) const {
-    if (!obj) {
-        return true;
+int FramelessHelper::getEffectiveTitleBarHeight(QObject *const obj) const {
+    if (m_titleBarHeight >= 0) {
+        return m_titleBarHeight;
     }
-    return !m_disableTitleBar.value(obj);
+    return getScreenInfo(getWindowScreen(obj)).titleBarHeight;
 }
 
-void FramelessHelper::setTitleBarEnabled(QObject *const obj, const bool val) {
-    if (obj) {
-        m_disableTitleBar[obj] = !val;
+void FramelessHelper::invalidatePlatformMetrics() {
+    // The outside resize border is as wide as the border.
+    for (auto &&obj : qAsConst(m_framelessObjects)) {
+        if (getResizeBorderOutside(obj)) {
+            updateOuterMargin(obj);
+        }
     }
 }
 
-void FramelessHelper::removeWindowFrame(QObject *const obj) {
-    if (obj) {
-        // Don't miss the Qt::Window flag.
-        const Qt::WindowFlags flags = Qt::Window | Qt::FramelessWindowHint;
+void FramelessHelper::toggleMaximized(QObject *const obj) {
+    // ### FIXME: If the current object is a QWidget, we can use
+    // getWindowHandle(object) to get the window handle, but if we call
+    // showMaximized() of that window, it will not be maximized, it will be
+    // moved to the top-left edge of the screen without changing it's size
+    // instead. Why? Convert the object to QWidget and call showMaximized()
+    // doesn't have this issue.
+    if (obj->isWindowType()) {
         const auto window = qobject_cast<QWindow *>(obj);
         if (window) {
-            window->setFlags(flags);
-            // MouseTracking is always enabled for QWindow.
-            window->installEventFilter(this);
+            if (window->windowStates().testFlag(
+                    Qt::WindowState::WindowFullScreen)) {
+                return;
+            }
+            if (window->windowStates().testFlag(
+                    Qt::WindowState::WindowMaximized)) {
+                window->showNormal();
+            } else {
+                window->showMaximized();
+            }
+            window->setCursor(Qt::CursorShape::ArrowCursor);
         }
+    }
 #ifdef QT_WIDGETS_LIB
-        else {
-            const auto widget = qobject_cast<QWidget *>(obj);
-            if (widget && widget->isTopLevel()) {
-                widget->setWindowFlags(flags);
-                // We can't get MouseMove events if MouseTracking is
-                // disabled.
-                widget->setMouseTracking(true);
-                widget->installEventFilter(this);
-                updateQtFrame(widget->windowHandle(), m_titleBarHeight);
+    else if (obj->isWidgetType()) {
+        const auto widget = qobject_cast<QWidget *>(obj);
+        if (widget) {
+            if (widget->isFullScreen()) {
+                return;
+            }
+            if (widget->isMaximized()) {
+                widget->showNormal();
+            } else {
+                widget->showMaximized();
             }
+            widget->setCursor(Qt::CursorShape::ArrowCursor);
         }
-#endif
     }
+#endif
 }
 
-bool FramelessHelper::eventFilter(QObject *object, QEvent *event) {
-    const auto isWindowTopLevel = [](QObject *const window) -> bool {
-        if (window) {
-            if (window->isWindowType()) {
-                const auto win = qobject_cast<QWindow *>(window);
-                if (win) {
-                    return win->isTopLevel();
-                }
-            }
-#ifdef QT_WIDGETS_LIB
-            else if (window->isWidgetType()) {
-                const auto widget = qobject_cast<QWidget *>(window);
-                if (widget) {
-                    return widget->isTopLevel();
-                }
-            }
-#endif
-        }
-        return false;
-    };
-    if (!object || !isWindowTopLevel(object)) {
+bool FramelessHelper::filterMouseEvent(QObject *const obj,
+                                       QMouseEvent *const mouseEvent) {
+    if (!obj || !mouseEvent) {
         return false;
     }
-    const auto getWindowEdges = [this](const QPointF &point, const int ww,
-                                       const int wh) -> Qt::Edges {
-        if (point.y() <= m_borderHeight) {
-            if (point.x() <= m_borderWidth) {
-                return Qt::Edge::TopEdge | Qt::Edge::LeftEdge;
-            }
-            if (point.x() >= (ww - m_borderWidth)) {
-                return Qt::Edge::TopEdge | Qt::Edge::RightEdge;
-            }
-            return Qt::Edge::TopEdge;
+    switch (mouseEvent->type()) {
+    case QEvent::MouseButtonDblClick: {
+        if (mouseEvent->button() != Qt::MouseButton::LeftButton) {
+            break;
         }
-        if (point.y() >= (wh - m_borderHeight)) {
-            if (point.x() <= m_borderWidth) {
-                return Qt::Edge::BottomEdge | Qt::Edge::LeftEdge;
-            }
-            if (point.x() >= (ww - m_borderWidth)) {
-                return Qt::Edge::BottomEdge | Qt::Edge::RightEdge;
-            }
-            return Qt::Edge::BottomEdge;
+        if (isInTitlebarArea(mouseEvent->screenPos(), mouseEvent->windowPos(),
+                             obj)) {
+            toggleMaximized(obj);
         }
-        if (point.x() <= m_borderWidth) {
-            return Qt::Edge::LeftEdge;
+    } break;
+    case QEvent::MouseButtonPress: {
+        // The native event filter has seen (and handled) the press already.
+        if ((mouseEvent->button() != Qt::MouseButton::LeftButton) ||
+            m_nativeEventFilter) {
+            break;
         }
-        if (point.x() >= (ww - m_borderWidth)) {
-            return Qt::Edge::RightEdge;
+        // Button events are never delayed, but the moves before them must
+        // not be handled after them.
+        flushMouseMove(obj);
+        // Qt synthesizes mouse events from the touch events nobody accepted.
+        // A tracked touch gesture starts it's own system move/resize once
+        // the finger moved far enough, the press must not start another one.
+        const bool synthesized =
+            mouseEvent->source() != Qt::MouseEventNotSynthesized;
+        if (synthesized &&
+            (m_touchGestures.value(obj).state != TouchState::Idle)) {
+            break;
         }
-        return {};
-    };
-    const auto getCursorShape = [](const Qt::Edges edges) -> Qt::CursorShape {
-        if ((edges.testFlag(Qt::Edge::TopEdge) &&
-             edges.testFlag(Qt::Edge::LeftEdge)) ||
-            (edges.testFlag(Qt::Edge::BottomEdge) &&
-             edges.testFlag(Qt::Edge::RightEdge))) {
-            return Qt::CursorShape::SizeFDiagCursor;
-        }
-        if ((edges.testFlag(Qt::Edge::TopEdge) &&
-             edges.testFlag(Qt::Edge::RightEdge)) ||
-            (edges.testFlag(Qt::Edge::BottomEdge) &&
-             edges.testFlag(Qt::Edge::LeftEdge))) {
-            return Qt::CursorShape::SizeBDiagCursor;
-        }
-        if (edges.testFlag(Qt::Edge::TopEdge) ||
-            edges.testFlag(Qt::Edge::BottomEdge)) {
-            return Qt::CursorShape::SizeVerCursor;
-        }
-        if (edges.testFlag(Qt::Edge::LeftEdge) ||
-            edges.testFlag(Qt::Edge::RightEdge)) {
-            return Qt::CursorShape::SizeHorCursor;
-        }
-        return Qt::CursorShape::ArrowCursor;
-    };
-    const auto isInSpecificAreas = [](const int x, const int y,
-                                      const QVector<QRect> &areas) -> bool {
-        if (!areas.isEmpty()) {
-            for (auto &&area : qAsConst(areas)) {
-                if (area.contains(x, y)) {
-                    return true;
-                }
-            }
+        moveOrResize(mouseEvent->screenPos(), mouseEvent->windowPos(), obj,
+                     !synthesized);
+    } break;
+    case QEvent::MouseButtonRelease: {
+        if (mouseEvent->button() == Qt::MouseButton::LeftButton) {
+            flushMouseMove(obj);
+            stopManualGrab(obj);
         }
-        return false;
-    };
-    const auto isInSpecificObjects =
-        [](const int x, const int y,
-           const QVector<QObject *> &objects) -> bool {
-        if (!objects.isEmpty()) {
-            for (auto &&obj : qAsConst(objects)) {
-                if (!obj) {
-                    continue;
-                }
-#ifdef QT_WIDGETS_LIB
-                const auto widget = qobject_cast<QWidget *>(obj);
-                if (widget) {
-                    const QPoint pos = widget->mapToGlobal({0, 0});
-                    if (QRect(pos.x(), pos.y(), widget->width(),
-                              widget->height())
-                            .contains(x, y)) {
-                        return true;
-                    }
-                }
-#endif
-#ifdef QT_QUICK_LIB
-                const auto quickItem = qobject_cast<QQuickItem *>(obj);
-                if (quickItem) {
-                    const QPointF pos = quickItem->mapToGlobal({0, 0});
-                    if (QRectF(pos.x(), pos.y(), quickItem->width(),
-                               quickItem->height())
-                            .contains(x, y)) {
-                        return true;
-                    }
+    } break;
+    case QEvent::MouseMove: {
+        if (!m_manualGrabs.value(obj).active && m_nativeEventFilter) {
+            // Nothing to do, the cursor is updated natively.
+            break;
+        }
+        queueMouseMove(obj, mouseEvent->windowPos(), mouseEvent->screenPos());
+    } break;
+    default:
+        break;
+    }
+    return false;
+}
+
+bool FramelessHelper::eventFilter(QObject *object, QEvent *event) {
+    if (object && object->isWindowType()) {
+        QObject *const owner =
+            m_windowOwners.value(static_cast<QWindow *>(object));
+        if (owner && (owner != object)) {
+            // The native window of a frameless widget. Unlike the widget, it
+            // gets the mouse moves without mouse tracking, so we filter the
+            // mouse events here, and watch it for the frame updates. All
+            // other events are handled through the widget.
+            switch (event->type()) {
+            case QEvent::UpdateRequest:
+                processFrameUpdate(owner);
+                break;
+            case QEvent::MouseButtonDblClick:
+            case QEvent::MouseButtonPress:
+            case QEvent::MouseButtonRelease:
+            case QEvent::MouseMove:
+                if (isWindowTopLevel(owner)) {
+                    return filterMouseEvent(owner,
+                                            static_cast<QMouseEvent *>(event));
                 }
-#endif
+                break;
+            default:
+                break;
             }
+            return false;
         }
+    }
+    if (event->type() == QEvent::UpdateRequest) {
+        processFrameUpdate(object);
         return false;
-    };
-    const auto isInIgnoreAreas =
-        [this, &isInSpecificAreas](const QPointF &point,
-                                   QObject *const window) -> bool {
-        if (!window) {
-            return false;
+    }
+    if (event->type() == QEvent::Resize) {
+        const auto it = m_roundedCorners.find(object);
+        if ((it != m_roundedCorners.end()) && (it->radius > 0) &&
+            !it->maskPending) {
+            // Update the mask at most once per frame during a resize.
+            it->maskPending = true;
+            requestFrameUpdate(object);
         }
-        return isInSpecificAreas(point.x(), point.y(), getIgnoreAreas(window));
-    };
-    const auto isInIgnoreObjects =
-        [this, &isInSpecificObjects](const QPointF &point,
-                                     QObject *const window) -> bool {
-#if defined(QT_WIDGETS_LIB) || defined(QT_QUICK_LIB)
-        if (!window) {
-            return false;
+        const auto inputShape = m_inputShapes.find(object);
+        if ((inputShape != m_inputShapes.end()) &&
+            !inputShape->updatePending) {
+            inputShape->updatePending = true;
+            requestFrameUpdate(object);
         }
-        return isInSpecificObjects(point.x(), point.y(),
-                                   getIgnoreObjects(window));
-#else
-        Q_UNUSED(point)
-        Q_UNUSED(window)
-        return false;
-#endif
-    };
-    const auto isInDraggableAreas =
-        [this, &isInSpecificAreas](const QPointF &point,
-                                   QObject *const window) -> bool {
-        if (!window) {
-            return false;
+    } else if (event->type() == QEvent::WinIdChange) {
+        // The native window of a widget has been (re)created.
+        if (m_framelessObjects.contains(object)) {
+            watchNativeWindow(object);
         }
-        const auto areas = getDraggableAreas(window);
-        return (areas.isEmpty()
-                    ? true
-                    : isInSpecificAreas(point.x(), point.y(), areas));
-    };
-    const auto isInDraggableObjects =
-        [this, &isInSpecificObjects](const QPointF &point,
-                                     QObject *const window) -> bool {
-#if defined(QT_WIDGETS_LIB) || defined(QT_QUICK_LIB)
-        if (!window) {
-            return false;
+    } else if (event->type() == QEvent::Show) {
+        if (m_inputShapes.contains(object)) {
+            updateInputShape(object);
         }
-        const auto objs = getDraggableObjects(window);
-        return (objs.isEmpty()
-                    ? true
-                    : isInSpecificObjects(point.x(), point.y(), objs));
-#else
-        Q_UNUSED(point)
-        Q_UNUSED(window)
+        if (getSystemBordersEnabled(object)) {
+            applySystemBorders(object);
+        }
+    }
+    if ((event->type() == QEvent::Paint) && getShadowEnabled(object)) {
+        // Below the widget's own painting.
+        paintShadow(object);
+    }
+    if (filterLiveResizeEvent(object, event)) {
         return true;
-#endif
-    };
-    const auto isResizePermitted =
-        [&isInIgnoreAreas, &isInIgnoreObjects](const QPointF &globalPoint,
-                                               const QPointF &point,
-                                               QObject *const window) -> bool {
-        if (!window) {
-            return false;
+    }
+    if (!object || !isWindowTopLevel(object)) {
+        return false;
+    }
+    switch (event->type()) {
+    case QEvent::MouseButtonDblClick:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseMove:
+        // The mouse events of a widget are filtered on it's native window,
+        // see above.
+        if (object->isWindowType()) {
+            return filterMouseEvent(object, static_cast<QMouseEvent *>(event));
         }
-        return (!isInIgnoreAreas(point, window) &&
-                !isInIgnoreObjects(globalPoint, window));
-    };
-    const auto isInTitlebarArea =
-        [this, &isInDraggableAreas, &isInDraggableObjects,
-         &isResizePermitted](const QPointF &globalPoint, const QPointF &point,
-                             QObject *const window) -> bool {
-        if (window) {
-            return ((point.y() <= m_titleBarHeight) &&
-                    isInDraggableAreas(point, window) &&
-                    isInDraggableObjects(globalPoint, window) &&
-                    isResizePermitted(globalPoint, point, window) &&
-                    getTitleBarEnabled(window));
+        break;
+    case QEvent::TouchBegin: {
+        const auto touchEvent = static_cast<QTouchEvent *>(event);
+        if (!touchEvent || touchEvent->touchPoints().isEmpty()) {
+            break;
         }
-        return false;
-    };
-    const auto moveOrResize = [this, &getWindowEdges, &isResizePermitted,
-                               &isInTitlebarArea](const QPointF &globalPoint,
-                                                  const QPointF &point,
-                                                  QObject *const object) {
+        // Hit-test once, the result is used for the whole gesture.
+        const auto point = touchEvent->touchPoints().first();
+        TOUCHGESTURE &gesture = m_touchGestures[object];
+        gesture = {};
+        gesture.state = TouchState::Pending;
+        gesture.startPos = point.screenPos();
         QWindow *const window = getWindowHandle(object);
         if (window) {
-            const Qt::Edges edges =
-                getWindowEdges(point, window->width(), window->height());
+            const Qt::Edges edges = getWindowEdges(
+                object, point.pos(), window->width(), window->height());
             if (edges == Qt::Edges{}) {
-                if (isInTitlebarArea(globalPoint, point, object)) {
-                    window->startSystemMove();
-                }
-            } else {
-                if (window->windowStates().testFlag(
-                        Qt::WindowState::WindowNoState) &&
-                    isResizePermitted(globalPoint, point, object) &&
-                    getResizable(object)) {
-                    window->startSystemResize(edges);
-                }
+                gesture.moveable =
+                    isInTitlebarArea(point.screenPos(), point.pos(), object);
+            } else if (window->windowStates().testFlag(
+                           Qt::WindowState::WindowNoState) &&
+                       isResizePermitted(point.screenPos(), point.pos(),
+                                         object) &&
+                       getResizable(object)) {
+                gesture.edges = edges;
             }
-        } else {
-            qWarning().noquote() << "Can't move or resize the window: failed "
-                                    "to acquire the window handle.";
+            gesture.pinchable =
+                window->windowStates().testFlag(
+                    Qt::WindowState::WindowNoState) &&
+                getResizable(object);
         }
-    };
-    switch (event->type()) {
-    case QEvent::MouseButtonDblClick: {
-        const auto mouseEvent = static_cast<QMouseEvent *>(event);
-        if (mouseEvent) {
-            if (mouseEvent->button() != Qt::MouseButton::LeftButton) {
+    } break;
+    case QEvent::TouchUpdate: {
+        const auto touchEvent = static_cast<QTouchEvent *>(event);
+        const auto it = m_touchGestures.find(object);
+        if (!touchEvent || (it == m_touchGestures.end()) ||
+            (it->state == TouchState::Idle) ||
+            (it->state == TouchState::Started)) {
+            // The system move/resize of this gesture has been started
+            // already, don't flood the compositor with more requests.
+            break;
+        }
+        const auto points = touchEvent->touchPoints();
+        if (points.size() >= 2) {
+            if (!it->pinchable) {
                 break;
             }
-            if (isInTitlebarArea(mouseEvent->screenPos(),
-                                 mouseEvent->windowPos(), object)) {
-                // ### FIXME: If the current object is a QWidget, we can use
-                // getWindowHandle(object) to get the window handle, but if we
-                // call showMaximized() of that window, it will not be
-                // maximized, it will be moved to the top-left edge of the
-                // screen without changing it's size instead. Why? Convert the
-                // object to QWidget and call showMaximized() doesn't have this
-                // issue.
-                if (object->isWindowType()) {
-                    const auto window = qobject_cast<QWindow *>(object);
-                    if (window) {
-                        if (window->windowStates().testFlag(
-                                Qt::WindowState::WindowFullScreen)) {
-                            break;
-                        }
-                        if (window->windowStates().testFlag(
-                                Qt::WindowState::WindowMaximized)) {
-                            window->showNormal();
-                        } else {
-                            window->showMaximized();
-                        }
-                        window->setCursor(Qt::CursorShape::ArrowCursor);
-                    }
-                }
-#ifdef QT_WIDGETS_LIB
-                else if (object->isWidgetType()) {
-                    const auto widget = qobject_cast<QWidget *>(object);
-                    if (widget) {
-                        if (widget->isFullScreen()) {
-                            break;
-                        }
-                        if (widget->isMaximized()) {
-                            widget->showNormal();
-                        } else {
-                            widget->showMaximized();
-                        }
-                        widget->setCursor(Qt::CursorShape::ArrowCursor);
-                    }
-                }
-#endif
+            // Pinch to resize around the center of the window.
+            const qreal distance =
+                QLineF(points.at(0).screenPos(), points.at(1).screenPos())
+                    .length();
+            if (it->state != TouchState::Pinching) {
+                it->state = TouchState::Pinching;
+                it->startDistance = qMax(distance, 1.0);
+                it->startGeometry = getWindowGeometry(object);
+                break;
             }
+            const qreal scale = distance / it->startDistance;
+            const QSize size = getBoundedWindowSize(
+                object,
+                (QSizeF(it->startGeometry.size()) * scale).toSize());
+            QRect geometry = {{}, size};
+            geometry.moveCenter(it->startGeometry.center());
+            it->pendingGeometry = geometry;
+            if (!it->updatePending) {
+                it->updatePending = true;
+                requestFrameUpdate(object);
+            }
+            break;
         }
-    } break;
-    case QEvent::MouseButtonPress: {
-        const auto mouseEvent = static_cast<QMouseEvent *>(event);
-        if (mouseEvent) {
-            if (mouseEvent->button() != Qt::MouseButton::LeftButton) {
-                break;
+        if ((it->state != TouchState::Pending) || points.isEmpty()) {
+            break;
+        }
+        // Don't start anything before the finger moved far enough, a tap
+        // must not become a drag.
+        if (QLineF(it->startPos, points.first().screenPos()).length() <
+            QGuiApplication::styleHints()->startDragDistance()) {
+            break;
+        }
+        it->state = TouchState::Started;
+        QWindow *const window = getWindowHandle(object);
+        if (window) {
+            if ((it->edges != Qt::Edges{}) || it->moveable) {
+                startSystemMoveResize(window, points.first().screenPos(),
+                                      it->edges, false);
             }
-            moveOrResize(mouseEvent->screenPos(), mouseEvent->windowPos(),
-                         object);
         }
     } break;
-    case QEvent::MouseMove: {
-        const auto mouseEvent = static_cast<QMouseEvent *>(event);
-        if (mouseEvent) {
-            QWindow *const window = getWindowHandle(object);
-            if (window) {
-                if (window->windowStates().testFlag(
-                        Qt::WindowState::WindowNoState) &&
-                    getResizable(object)) {
-                    window->setCursor(getCursorShape(
-                        getWindowEdges(mouseEvent->windowPos(), window->width(),
-                                       window->height())));
-                }
-            }
-#ifdef QT_WIDGETS_LIB
-            else {
-                const auto widget = qobject_cast<QWidget *>(object);
-                if (widget) {
-                    if (!widget->isMinimized() && !widget->isMaximized() &&
-                        !widget->isFullScreen() && getResizable(object)) {
-                        widget->setCursor(getCursorShape(
-                            getWindowEdges(mouseEvent->windowPos(),
-                                           widget->width(), widget->height())));
-                    }
-                }
+    case QEvent::TouchEnd:
+    case QEvent::TouchCancel: {
+        const auto it = m_touchGestures.find(object);
+        if (it != m_touchGestures.end()) {
+            if (it->updatePending) {
+                it->updatePending = false;
+                setWindowGeometry(object, it->pendingGeometry, false);
             }
-#endif
+            it->state = TouchState::Idle;
         }
     } break;
-    case QEvent::TouchBegin:
-    case QEvent::TouchUpdate: {
-        const auto point =
-            static_cast<QTouchEvent *>(event)->touchPoints().first();
-        moveOrResize(point.screenPos(), point.pos(), object);
-    } break;
     default:
         break;
     }
@@ -24,27 +24,83 @@
 
 #pragma once
 
+#include "framelessregionchannel.h"
+
+#include <QColor>
+#include <QElapsedTimer>
 #include <QHash>
 #include <QObject>
+#include <QPixmap>
+#include <QPoint>
 #include <QPointer>
 #include <QRect>
+#include <QRegion>
+#include <QSharedPointer>
+#include <QSize>
 #include <QVector>
 
 QT_BEGIN_NAMESPACE
 QT_FORWARD_DECLARE_CLASS(QWindow)
+QT_FORWARD_DECLARE_CLASS(QScreen)
+QT_FORWARD_DECLARE_CLASS(QLayout)
+QT_FORWARD_DECLARE_CLASS(QMouseEvent)
+QT_FORWARD_DECLARE_CLASS(QTimer)
 QT_END_NAMESPACE
 
+class X11NativeEventFilter;
+
 class FramelessHelper : public QObject {
     Q_OBJECT
     Q_DISABLE_COPY_MOVE(FramelessHelper)
 
 public:
+    enum class Placement { Center, Cascade, Tile };
+
     explicit FramelessHelper(QObject *parent = nullptr);
-    ~FramelessHelper() override = default;
+    ~FramelessHelper() override;
 
     static void updateQtFrame(QWindow *const window, const int titleBarHeight);
+    // Move the window to the center of the available area of it's screen.
     static void moveWindowToDesktopCenter(QObject *const obj);
+    // Place many windows with one call. Each window is moved (and resized
+    // when tiling) exactly once, so call it before show() to avoid any
+    // further geometry change after the native window appears. If screen is
+    // null, the screen of the first window is used.
+    static void placeWindows(const QVector<QObject *> &objs,
+                             const Placement placement,
+                             QScreen *const screen = nullptr);
+
+    // Save or restore the geometry, maximized state and screen of the
+    // window. Many windows can share one file, each of them is identified by
+    // it's key. Restore the state before the window is shown, so that the
+    // native window is created with it's final geometry and state directly.
+    static bool saveWindowState(QObject *const obj, const QString &key,
+                                const QString &fileName);
+    static bool restoreWindowState(QObject *const obj, const QString &key,
+                                   const QString &fileName);
+
+    // How many times removeWindowFrame() had to change the flags of a window
+    // which already had a native window, which makes Qt recreate (or
+    // reconfigure) it. It should stay at zero if all windows are made
+    // frameless before they are shown.
+    static int getPlatformWindowRecreationCount();
 
+    // Mouse moves are handled at most once per pass of the event loop for
+    // every window, only the latest position matters. How many moves have
+    // been handled, and how many have been dropped in favour of a newer one,
+    // for all windows.
+    static int getHandledMouseMoveCount();
+    static int getCoalescedMouseMoveCount();
+
+    // How many times a system move or resize has been requested from the
+    // window system (or the window manager directly), for all windows. One
+    // drag, with the mouse or a finger, should request exactly one.
+    static int getSystemMoveResizeCount();
+
+    // The resize border and the title bar follow the desktop by default
+    // (DPI, cursor size and the border size of KWin, read once and cached
+    // per screen), setting a value overrides that. The getters return the
+    // value of the primary screen then.
     int getBorderWidth() const;
     void setBorderWidth(const int val);
 
@@ -80,18 +136,284 @@ public:
     bool getTitleBarEnabled(QObject *const obj) const;
     void setTitleBarEnabled(QObject *const obj, const bool val);
 
+    // Live resize mode (QWidget only): while the window is being resized,
+    // the layout is run at most once per frame and the newly exposed area is
+    // padded with the background colour in between. A full layout pass is
+    // done once the resize settles. Disabled by default.
+    bool getLiveResizeEnabled(QObject *const obj) const;
+    void setLiveResizeEnabled(QObject *const obj, const bool val);
+
+    // Outline resize mode: while an edge is being dragged, only an outline
+    // of the new geometry is shown and the window itself is resized once,
+    // when the mouse button is released. Useful for windows whose content
+    // is very expensive to lay out. Disabled by default.
+    bool getOutlineResizeEnabled(QObject *const obj) const;
+    void setOutlineResizeEnabled(QObject *const obj, const bool val);
+
+    // Client-side drop shadow (QWidget only), for window managers which
+    // don't draw one for frameless windows. The shadow is drawn into a
+    // transparent margin of "radius" pixels around the content, so the
+    // contents margins of the widget are overridden while it's enabled.
+    // Enable it before the window is shown: the margin can only be
+    // transparent if the native window is created with an alpha channel.
+    bool getShadowEnabled(QObject *const obj) const;
+    void setShadowEnabled(QObject *const obj, const bool val);
+
+    int getShadowRadius(QObject *const obj) const;
+    void setShadowRadius(QObject *const obj, const int val);
+
+    QColor getShadowColor(QObject *const obj) const;
+    void setShadowColor(QObject *const obj, const QColor &val);
+
+    // Rounded corners, done with a window mask. If the shadow is enabled the
+    // corners of the content are painted rounded instead. Zero (the default)
+    // means square corners.
+    int getCornerRadius(QObject *const obj) const;
+    void setCornerRadius(QObject *const obj, const int val);
+
+    // The colour the newly exposed area of the window is filled with before
+    // the application painted it, instead of the default white. Use the
+    // colour of your content to get rid of the flashes during a resize. Only
+    // QWidget and QQuickWindow are supported.
+    QColor getBackgroundColor(QObject *const obj) const;
+    void setBackgroundColor(QObject *const obj, const QColor &val);
+
+    // Snapping while the window is dragged by it's title bar: the edges
+    // stick to the edges of the screens and of the other windows, and
+    // dragging the mouse to the edge of a screen tiles the window to half
+    // (left, right), a quarter (corners) or all (top) of it. Meant for window
+    // managers which don't do this themselves, disabled by default.
+    bool getSnapEnabled(QObject *const obj) const;
+    void setSnapEnabled(QObject *const obj, const bool val);
+
+    // Let the mouse events go through the whole window, or only through
+    // some areas of it, to the windows below. On X11 this is done with the
+    // input shape of the window, so the X server routes the events and we
+    // don't have to hit-test anything. Elsewhere only the whole window can
+    // be made transparent.
+    bool getMouseTransparent(QObject *const obj) const;
+    void setMouseTransparent(QObject *const obj, const bool val);
+
+    QVector<QRect> getMouseTransparentAreas(QObject *const obj) const;
+    void setMouseTransparentAreas(QObject *const obj,
+                                  const QVector<QRect> &val);
+
+    // Put the resize border into a transparent margin outside of the content
+    // (QWidget only) instead of on top of the content. Needs X11 to make the
+    // rest of the margin click-through. Like the shadow, enable it before
+    // the window is shown.
+    bool getResizeBorderOutside(QObject *const obj) const;
+    void setResizeBorderOutside(QObject *const obj, const bool val);
+
+    // X11 only, hybrid mode: instead of removing the whole frame, ask the
+    // window manager (through _MOTIF_WM_HINTS) to remove only the title bar
+    // and keep drawing and handling the resize borders. We only handle the
+    // dragging and double clicking of our own title bar then. Must be called
+    // before removeWindowFrame().
+    bool getSystemBordersEnabled(QObject *const obj) const;
+    void setSystemBordersEnabled(QObject *const obj, const bool val);
+
+    // Hit regions of a window rendered by another process and embedded into
+    // this one (the QWindow::fromWinId() window or it's
+    // QWidget::createWindowContainer()), published by that process through a
+    // FramelessRegionChannel with the same key. It's draggable areas belong
+    // to the title bar, it's ignore areas neither drag nor resize the
+    // window. Only the mouse events the embedded window lets through (with
+    // it's input shape, for example) reach the frameless window though.
+    void setRegionChannel(QObject *const obj, QObject *const container,
+                          const QString &key);
+    void clearRegionChannel(QObject *const obj);
+
+    // X11 only: hit-test the raw xcb button press and motion events of the
+    // frameless windows before Qt translates and delivers them, so it also
+    // works if a child widget or item accepts the mouse press. Disabled by
+    // default.
+    bool getNativeEventFilterEnabled() const;
+    void setNativeEventFilterEnabled(const bool val);
+
     void removeWindowFrame(QObject *const obj);
 
 protected:
     bool eventFilter(QObject *object, QEvent *event) override;
 
 private:
-    // ### TODO: The default border width and height on Windows is 8 pixels if
-    // the scale factor is 1.0. Don't know how to acquire these values on UNIX
-    // platforms through native API.
-    int m_borderWidth = 8, m_borderHeight = 8, m_titleBarHeight = 30;
+    friend class X11NativeEventFilter;
+
+    // Hit-testing, shared by eventFilter() and the native event filter.
+    Qt::Edges getWindowEdges(QObject *const obj, const QPointF &point,
+                             const int ww, const int wh) const;
+    bool isInSpecificObjects(const QPointF &globalPoint,
+                             const QVector<QObject *> &objects);
+    bool isResizePermitted(const QPointF &globalPoint, const QPointF &point,
+                           QObject *const obj);
+    bool isInTitlebarArea(const QPointF &globalPoint, const QPointF &point,
+                          QObject *const obj);
+    // True if a child widget under the point handles the mouse itself.
+    bool isInInteractiveChild(const QPointF &point, QObject *const obj) const;
+    // Returns true if a move or resize has been started. "mouse" is false
+    // for presses that come from a touch screen.
+    bool moveOrResize(const QPointF &globalPoint, const QPointF &point,
+                      QObject *const obj, const bool mouse);
+    // The frameless window (QWindow or QWidget) of the native window.
+    QObject *getFramelessObject(const quintptr windowId,
+                                QWindow **window) const;
+    void updateCursor(QObject *const obj, const QPointF &point);
+    void toggleMaximized(QObject *const obj);
+
+    // The resize border and title bar of the screen of the window, the
+    // values set by the user win over the ones of the desktop.
+    int getEffectiveBorderWidth(QObject *const obj) const;
+    int getEffectiveBorderHeight(QObject *const obj) const;
+    int getEffectiveTitleBarHeight(QObject *const obj) const;
+    // Watch the settings of the desktop, once for all the helpers of the
+    // application, and call invalidatePlatformMetrics() of every helper
+    // after the cached platform metrics have been read again.
+    static void watchPlatformMetrics();
+    void invalidatePlatformMetrics();
+
+    // Client driven move/resize, used when the platform can't do it for us.
+    void startManualGrab(QObject *const obj, const Qt::Edges edges,
+                         const QPointF &globalPoint);
+    void updateManualGrab(QObject *const obj, const QPointF &globalPoint);
+    void stopManualGrab(QObject *const obj);
+
+    void startLiveResize(QObject *const obj);
+    void stopLiveResize(QObject *const obj);
+    void deliverLiveResize(QObject *const obj);
+    bool filterLiveResizeEvent(QObject *const obj, QEvent *const event);
+    // The mouse events of a QWindow, or of the native window of a QWidget.
+    bool filterMouseEvent(QObject *const obj, QMouseEvent *const mouseEvent);
+
+    void updateMask(QObject *const obj);
+
+    // The transparent margin around the content of a widget, for the shadow
+    // or the outside resize border.
+    int getOuterMargin(QObject *const obj) const;
+    void updateOuterMargin(QObject *const obj);
+    void updateInputShape(QObject *const obj);
+    void applySystemBorders(QObject *const obj);
+    void paintShadow(QObject *const obj);
+
+    // Ask for a QEvent::UpdateRequest of the window, processFrameUpdate()
+    // will be called once per frame no matter how often this is called.
+    void requestFrameUpdate(QObject *const obj);
+    void processFrameUpdate(QObject *const obj);
+    // Filter the events of the native window of a widget as well, see
+    // m_windowOwners.
+    void watchNativeWindow(QObject *const obj);
+    // Handle the pending mouse move of the window, if any.
+    void flushMouseMove(QObject *const obj);
+    // Coalesce the mouse moves of a window, see flushMouseMoves().
+    void queueMouseMove(QObject *const obj, const QPointF &windowPos,
+                        const QPointF &screenPos);
+    void flushMouseMoves();
+    // Forget everything about a destroyed window.
+    void removeObjectState(QObject *const obj);
+
+    using MANUALGRAB = struct _MANUALGRAB {
+        bool active = false, updatePending = false;
+        // Empty edges means moving.
+        Qt::Edges edges = {};
+        QPoint pressPos = {};
+        QRect startGeometry = {}, pendingGeometry = {};
+        // The outline of the new geometry in the outline resize mode, or the
+        // preview of the snap zone.
+        bool outlineOnly = false;
+        QPointer<QWindow> outline = nullptr;
+        // Sorted snap lines of both axes, and the screens, collected when
+        // the grab starts.
+        QVector<int> snapLinesX = {}, snapLinesY = {};
+        QVector<QRect> snapScreens = {}, snapAvailableGeometries = {};
+        QRect snapZone = {};
+    };
+
+    using LIVERESIZE = struct _LIVERESIZE {
+        bool enabled = false, active = false, resizePending = false;
+        // The size the layout has been run for.
+        QSize laidOutSize = {};
+        // The layout we disabled for the session.
+        QPointer<QLayout> layout = {};
+        // What the widget looked like when the session started, drawn
+        // instead of it's own painting while the layout is out of date.
+        QPixmap lastFrame = {};
+        QElapsedTimer frameTimer = {}, burstTimer = {};
+        QPointer<QTimer> settleTimer = nullptr;
+    };
+
+    static constexpr int m_defaultShadowRadius = 16;
+    static constexpr QRgb m_defaultShadowColor = 0x50000000;
+
+    using SHADOW = struct _SHADOW {
+        bool enabled = false;
+        int radius = m_defaultShadowRadius;
+        QColor color = QColor::fromRgba(m_defaultShadowColor);
+        // The outer margin last applied to the widget, see
+        // updateOuterMargin().
+        int appliedMargin = 0;
+    };
+
+    using ROUNDEDCORNERS = struct _ROUNDEDCORNERS {
+        int radius = 0;
+        bool maskPending = false;
+    };
+
+    using INPUTSHAPE = struct _INPUTSHAPE {
+        bool transparent = false, resizeBorderOutside = false,
+             updatePending = false, applied = false;
+        // The "only supported on X11" warning has been logged.
+        bool warned = false;
+        QVector<QRect> transparentAreas = {};
+        // The input region last sent to the window system.
+        QRegion region = {};
+    };
+
+    enum class TouchState { Idle, Pending, Started, Pinching };
+
+    using TOUCHGESTURE = struct _TOUCHGESTURE {
+        TouchState state = TouchState::Idle;
+        // Hit-test result of TouchBegin.
+        Qt::Edges edges = {};
+        bool moveable = false, pinchable = false, updatePending = false;
+        QPointF startPos = {};
+        qreal startDistance = 0.0;
+        QRect startGeometry = {}, pendingGeometry = {};
+    };
+
+    using REGIONCHANNEL = struct _REGIONCHANNEL {
+        QPointer<QObject> container = nullptr;
+        QSharedPointer<FramelessRegionChannel> channel = nullptr;
+    };
+    // The regions of the region channel, in the coordinates of the window.
+    FramelessRegionChannel::REGIONS getChannelRegions(QObject *const obj) const;
+
+    using PENDINGMOVE = struct _PENDINGMOVE {
+        bool pending = false;
+        QPointF windowPos = {}, screenPos = {};
+    };
+
+    // -1 means the value of the desktop of the screen of the window.
+    int m_borderWidth = -1, m_borderHeight = -1, m_titleBarHeight = -1;
     QHash<QObject *, QVector<QRect>> m_ignoreAreas = {}, m_draggableAreas = {};
     QHash<QObject *, QVector<QPointer<QObject>>> m_ignoreObjects = {},
                                                  m_draggableObjects = {};
-    QHash<QObject *, bool> m_fixedSize = {}, m_disableTitleBar = {};
+    QHash<QObject *, bool> m_fixedSize = {}, m_disableTitleBar = {},
+                           m_outlineResize = {}, m_snapEnabled = {},
+                           m_systemBorders = {};
+    QHash<QObject *, MANUALGRAB> m_manualGrabs = {};
+    QHash<QObject *, LIVERESIZE> m_liveResizes = {};
+    QHash<QObject *, SHADOW> m_shadows = {};
+    QHash<QObject *, ROUNDEDCORNERS> m_roundedCorners = {};
+    QHash<QObject *, TOUCHGESTURE> m_touchGestures = {};
+    QHash<QObject *, INPUTSHAPE> m_inputShapes = {};
+    QHash<QObject *, PENDINGMOVE> m_pendingMoves = {};
+    // A call of flushMouseMoves() has been queued.
+    bool m_mouseMovesQueued = false;
+    QHash<QObject *, REGIONCHANNEL> m_regionChannels = {};
+    // All windows removeWindowFrame() has been called for.
+    QVector<QObject *> m_framelessObjects = {};
+    X11NativeEventFilter *m_nativeEventFilter = nullptr;
+    QHash<QObject *, QColor> m_backgroundColors = {};
+    // Native windows of the frameless widgets and the widgets themselves,
+    // for the frame updates and the mouse events.
+    QHash<QWindow *, QObject *> m_windowOwners = {};
 };
@@ -0,0 +1,28 @@
+# The UNIX sources of FramelessHelper, shared by the example and by the tests
+# and benchmarks in "tests" and "bench".
+INCLUDEPATH += $$PWD
+QT += gui-private
+qtHaveModule(widgets): QT += widgets
+qtHaveModule(quick) {
+    QT += quick
+    HEADERS += $$PWD/framelessquickhelper.h
+    SOURCES += $$PWD/framelessquickhelper.cpp
+}
+CONFIG += c++17 strict_c++ warn_on utf8_source
+DEFINES += QT_NO_CAST_FROM_ASCII QT_NO_CAST_TO_ASCII
+# Talk to the X11 window manager directly when the xcb headers are available,
+# otherwise only the Qt API is used. The libraries themselves are not linked,
+# their functions are resolved at runtime (see symbolresolver.h).
+unix:!macx:packagesExist(xcb) {
+    DEFINES += FLH_HAVE_XCB
+    # For the XI2 events Qt uses.
+    packagesExist(xcb-xinput): DEFINES += FLH_HAVE_XCB_XINPUT
+    # Input shapes, for the mouse transparent areas.
+    packagesExist(xcb-shape): DEFINES += FLH_HAVE_XCB_SHAPE
+}
+HEADERS += $$PWD/framelesshelper.h $$PWD/framelessbuttonicons.h \
+    $$PWD/x11nativeeventfilter.h $$PWD/symbolresolver.h \
+    $$PWD/framelessregionchannel.h
+SOURCES += $$PWD/framelesshelper.cpp $$PWD/framelessbuttonicons.cpp \
+    $$PWD/x11nativeeventfilter.cpp $$PWD/symbolresolver.cpp \
+    $$PWD/framelessregionchannel.cpp
@@ -1,15 +1,13 @@
 TARGET = framelessapplication
 CONFIG(debug, debug|release): TARGET = $$join(TARGET,,,_debug)
 TEMPLATE = app
-QT += gui-private
-qtHaveModule(widgets): QT += widgets
+include(framelesshelper_unix.pri)
 qtHaveModule(quick) {
-    QT += quick
-    HEADERS += framelessquickhelper.h
-    SOURCES += framelessquickhelper.cpp
+    # Compile the QML files in resources.qrc ahead of time (qmlcachegen), so
+    # the engine doesn't need to parse and compile them on every launch.
+    # Pass "CONFIG+=flh_no_qtquickcompiler" to qmake to load them from source.
+    !flh_no_qtquickcompiler: CONFIG += qtquickcompiler
 }
-CONFIG += c++17 strict_c++ warn_on utf8_source
-DEFINES += QT_NO_CAST_FROM_ASCII QT_NO_CAST_TO_ASCII
 VERSION = 1.0.0
-HEADERS += framelesshelper.h
-SOURCES += framelesshelper.cpp main_unix.cpp
+SOURCES += main_unix.cpp
+RESOURCES += resources.qrc
@@ -0,0 +1,20 @@
+# The Windows sources of FramelessHelper, shared by the example and by the
+# tests and benchmarks in "tests" and "bench".
+INCLUDEPATH += $$PWD
+QT += gui-private
+qtHaveModule(widgets): QT += widgets
+qtHaveModule(quick) {
+    QT += quick
+    HEADERS += $$PWD/framelessquickhelper.h
+    SOURCES += $$PWD/framelessquickhelper.cpp
+}
+CONFIG += c++17 strict_c++ utf8_source warn_on
+DEFINES += WIN32_LEAN_AND_MEAN QT_NO_CAST_FROM_ASCII QT_NO_CAST_TO_ASCII
+flh_link_syslib {
+    DEFINES += WNEF_LINK_SYSLIB
+    LIBS += -luser32 -lgdi32 -ldwmapi
+}
+HEADERS += $$PWD/winnativeeventfilter.h $$PWD/framelessbuttonicons.h \
+    $$PWD/symbolresolver.h $$PWD/win32backend.h
+SOURCES += $$PWD/winnativeeventfilter.cpp $$PWD/framelessbuttonicons.cpp \
+    $$PWD/symbolresolver.cpp $$PWD/win32backend.cpp
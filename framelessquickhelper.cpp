@@ -26,20 +26,76 @@
 
 #ifdef Q_OS_WINDOWS
 #include "winnativeeventfilter.h"
+#else
+#include "framelesshelper.h"
+#include <QHash>
 #endif
 #include <QQuickWindow>
 
-#ifdef Q_OS_WINDOWS
 namespace {
 
 const int m_defaultBorderWidth = 8, m_defaultBorderHeight = 8,
           m_defaultTitleBarHeight = 30;
 
+#ifndef Q_OS_WINDOWS
+// One engine (event filter + per-window state) per QQuickWindow, no matter
+// how many FramelessQuickHelper items are placed inside that window, or how
+// often they are created and destroyed (by a Loader, for example).
+QHash<QQuickWindow *, FramelessHelper *> m_sharedEngines;
+
+FramelessHelper *getSharedEngine(QQuickWindow *const window) {
+    if (!window) {
+        return nullptr;
+    }
+    FramelessHelper *&engine = m_sharedEngines[window];
+    if (!engine) {
+        // The window owns the engine, so the window stays frameless and
+        // keeps it's state for as long as it lives.
+        engine = new FramelessHelper(window);
+        QObject::connect(engine, &QObject::destroyed, engine,
+                         [window]() { m_sharedEngines.remove(window); });
+    }
+    return engine;
 }
 #endif
 
+} // namespace
+
 FramelessQuickHelper::FramelessQuickHelper(QQuickItem *parent)
-    : QQuickItem(parent) {}
+    : QQuickItem(parent) {
+#ifndef Q_OS_WINDOWS
+    attachToWindow(window());
+#endif
+}
+
+FramelessQuickHelper::~FramelessQuickHelper() {
+#ifndef Q_OS_WINDOWS
+    attachToWindow(nullptr);
+#endif
+}
+
+void FramelessQuickHelper::itemChange(ItemChange change,
+                                      const ItemChangeData &value) {
+    QQuickItem::itemChange(change, value);
+#ifndef Q_OS_WINDOWS
+    if (change == ItemSceneChange) {
+        attachToWindow(value.window);
+    }
+#endif
+}
+
+#ifndef Q_OS_WINDOWS
+void FramelessQuickHelper::attachToWindow(QQuickWindow *window) {
+    if (window == m_attachedWindow) {
+        return;
+    }
+    m_attachedWindow = window;
+    m_framelessHelper = getSharedEngine(m_attachedWindow);
+    if (m_attachedWindow && m_framelessOnCreate) {
+        m_framelessHelper->removeWindowFrame(m_attachedWindow);
+    }
+}
+#endif
 
 int FramelessQuickHelper::borderWidth() const {
 #ifdef Q_OS_WINDOWS
@@ -53,7 +109,10 @@ int FramelessQuickHelper::borderWidth() const {
     }
     return m_defaultBorderWidth;
 #else
-    return m_framelessHelper.getBorderWidth();
+    if (m_framelessHelper) {
+        return m_framelessHelper->getBorderWidth();
+    }
+    return m_defaultBorderWidth;
 #endif
 }
 
@@ -71,8 +130,10 @@ void FramelessQuickHelper::setBorderWidth(const int val) {
         }
     }
 #else
-    m_framelessHelper.setBorderWidth(val);
-    Q_EMIT borderWidthChanged(val);
+    if (m_framelessHelper) {
+        m_framelessHelper->setBorderWidth(val);
+        Q_EMIT borderWidthChanged(val);
+    }
 #endif
 }
 
@@ -88,7 +149,10 @@ int FramelessQuickHelper::borderHeight() const {
     }
     return m_defaultBorderHeight;
 #else
-    return m_framelessHelper.getBorderHeight();
+    if (m_framelessHelper) {
+        return m_framelessHelper->getBorderHeight();
+    }
+    return m_defaultBorderHeight;
 #endif
 }
 
@@ -106,8 +170,10 @@ void FramelessQuickHelper::setBorderHeight(const int val) {
         }
     }
 #else
-    m_framelessHelper.setBorderHeight(val);
-    Q_EMIT borderHeightChanged(val);
+    if (m_framelessHelper) {
+        m_framelessHelper->setBorderHeight(val);
+        Q_EMIT borderHeightChanged(val);
+    }
 #endif
 }
 
@@ -124,7 +190,10 @@ int FramelessQuickHelper::titleBarHeight() const {
     }
     return m_defaultTitleBarHeight;
 #else
-    return m_framelessHelper.getTitleBarHeight();
+    if (m_framelessHelper) {
+        return m_framelessHelper->getTitleBarHeight();
+    }
+    return m_defaultTitleBarHeight;
 #endif
 }
 
@@ -142,8 +211,10 @@ void FramelessQuickHelper::setTitleBarHeight(const int val) {
         }
     }
 #else
-    m_framelessHelper.setTitleBarHeight(val);
-    Q_EMIT titleBarHeightChanged(val);
+    if (m_framelessHelper) {
+        m_framelessHelper->setTitleBarHeight(val);
+        Q_EMIT titleBarHeightChanged(val);
+    }
 #endif
 }
 
@@ -159,7 +230,7 @@ bool FramelessQuickHelper::resizable() const {
             }
         }
 #else
-        return m_framelessHelper.getResizable(win);
+        return m_framelessHelper->getResizable(win);
 #endif
     }
     return true;
@@ -178,7 +249,7 @@ void FramelessQuickHelper::setResizable(const bool val) {
             }
         }
 #else
-        m_framelessHelper.setResizable(win, val);
+        m_framelessHelper->setResizable(win, val);
 #endif
     }
 }
@@ -195,7 +266,7 @@ bool FramelessQuickHelper::titleBarEnabled() const {
             }
         }
 #else
-        return m_framelessHelper.getTitleBarEnabled(win);
+        return m_framelessHelper->getTitleBarEnabled(win);
 #endif
     }
     return true;
@@ -214,11 +285,28 @@ void FramelessQuickHelper::setTitleBarEnabled(const bool val) {
             }
         }
 #else
-        m_framelessHelper.setTitleBarEnabled(win, val);
+        m_framelessHelper->setTitleBarEnabled(win, val);
 #endif
     }
 }
 
+bool FramelessQuickHelper::framelessOnCreate() const {
+    return m_framelessOnCreate;
+}
+
+void FramelessQuickHelper::setFramelessOnCreate(const bool val) {
+    if (m_framelessOnCreate == val) {
+        return;
+    }
+    m_framelessOnCreate = val;
+#ifndef Q_OS_WINDOWS
+    if (m_framelessOnCreate && m_framelessHelper) {
+        m_framelessHelper->removeWindowFrame(m_attachedWindow);
+    }
+#endif
+    Q_EMIT framelessOnCreateChanged(val);
+}
+
 QSize FramelessQuickHelper::minimumSize() const {
     const auto win = window();
     if (win) {
@@ -302,7 +390,7 @@ void FramelessQuickHelper::removeWindowFrame(const bool center) {
             WinNativeEventFilter::addFramelessWindow(hWnd);
         }
 #else
-        m_framelessHelper.removeWindowFrame(win);
+        m_framelessHelper->removeWindowFrame(win);
 #endif
     }
     if (center) {
@@ -336,7 +424,7 @@ void FramelessQuickHelper::setIgnoreAreas(const QVector<QRect> &val) {
             }
         }
 #else
-        m_framelessHelper.setIgnoreAreas(win, val);
+        m_framelessHelper->setIgnoreAreas(win, val);
 #endif
     }
 }
@@ -353,7 +441,7 @@ void FramelessQuickHelper::clearIgnoreAreas() {
             }
         }
 #else
-        m_framelessHelper.clearIgnoreAreas(win);
+        m_framelessHelper->clearIgnoreAreas(win);
 #endif
     }
 }
@@ -370,7 +458,7 @@ void FramelessQuickHelper::addIgnoreArea(const QRect &val) {
             }
         }
 #else
-        m_framelessHelper.addIgnoreArea(win, val);
+        m_framelessHelper->addIgnoreArea(win, val);
 #endif
     }
 }
@@ -387,7 +475,7 @@ void FramelessQuickHelper::setDraggableAreas(const QVector<QRect> &val) {
             }
         }
 #else
-        m_framelessHelper.setDraggableAreas(win, val);
+        m_framelessHelper->setDraggableAreas(win, val);
 #endif
     }
 }
@@ -404,7 +492,7 @@ void FramelessQuickHelper::clearDraggableAreas() {
             }
         }
 #else
-        m_framelessHelper.clearDraggableAreas(win);
+        m_framelessHelper->clearDraggableAreas(win);
 #endif
     }
 }
@@ -421,7 +509,7 @@ void FramelessQuickHelper::addDraggableArea(const QRect &val) {
             }
         }
 #else
-        m_framelessHelper.addDraggableArea(win, val);
+        m_framelessHelper->addDraggableArea(win, val);
 #endif
     }
 }
@@ -448,7 +536,7 @@ void FramelessQuickHelper::setIgnoreObjects(const QVector<QQuickItem *> &val) {
             for (auto &&obj : qAsConst(val)) {
                 objs.append(obj);
             }
-            m_framelessHelper.setIgnoreObjects(win, objs);
+            m_framelessHelper->setIgnoreObjects(win, objs);
         }
 #endif
     }
@@ -466,7 +554,7 @@ void FramelessQuickHelper::clearIgnoreObjects() {
             }
         }
 #else
-        m_framelessHelper.clearIgnoreObjects(win);
+        m_framelessHelper->clearIgnoreObjects(win);
 #endif
     }
 }
@@ -483,7 +571,7 @@ void FramelessQuickHelper::addIgnoreObject(QQuickItem *val) {
             }
         }
 #else
-        m_framelessHelper.addIgnoreObject(win, val);
+        m_framelessHelper->addIgnoreObject(win, val);
 #endif
     }
 }
@@ -511,7 +599,7 @@ void FramelessQuickHelper::setDraggableObjects(
             for (auto &&obj : qAsConst(val)) {
                 objs.append(obj);
             }
-            m_framelessHelper.setDraggableObjects(win, objs);
+            m_framelessHelper->setDraggableObjects(win, objs);
         }
 #endif
     }
@@ -529,7 +617,7 @@ void FramelessQuickHelper::clearDraggableObjects() {
             }
         }
 #else
-        m_framelessHelper.clearDraggableObjects(win);
+        m_framelessHelper->clearDraggableObjects(win);
 #endif
     }
 }
@@ -546,7 +634,7 @@ void FramelessQuickHelper::addDraggableObject(QQuickItem *val) {
             }
         }
 #else
-        m_framelessHelper.addDraggableObject(win, val);
+        m_framelessHelper->addDraggableObject(win, val);
 #endif
     }
 }
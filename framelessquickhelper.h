@@ -33,7 +33,11 @@
 #endif
 
 #ifndef Q_OS_WINDOWS
-#include "framelesshelper.h"
+QT_BEGIN_NAMESPACE
+QT_FORWARD_DECLARE_CLASS(QQuickWindow)
+QT_END_NAMESPACE
+
+class FramelessHelper;
 #endif
 
 #if (QT_VERSION < QT_VERSION_CHECK(5, 13, 0))
@@ -63,10 +67,18 @@ class FramelessQuickHelper : public QQuickItem {
                    maximumSizeChanged)
     Q_PROPERTY(bool titleBarEnabled READ titleBarEnabled WRITE
                    setTitleBarEnabled NOTIFY titleBarEnabledChanged)
+    // Remove the window frame as soon as the helper is attached to it's
+    // window, which happens before the window's native window is created.
+    // Calling removeWindowFrame() from Component.onCompleted is too late: the
+    // window has been shown already by then, so Qt has to recreate it.
+    // Only has an effect on non-Windows platforms, WinNativeEventFilter
+    // doesn't change the window flags at all.
+    Q_PROPERTY(bool framelessOnCreate READ framelessOnCreate WRITE
+                   setFramelessOnCreate NOTIFY framelessOnCreateChanged)
 
 public:
     explicit FramelessQuickHelper(QQuickItem *parent = nullptr);
-    ~FramelessQuickHelper() override = default;
+    ~FramelessQuickHelper() override;
 
     int borderWidth() const;
     void setBorderWidth(const int val);
@@ -89,6 +101,9 @@ public:
     bool titleBarEnabled() const;
     void setTitleBarEnabled(const bool val);
 
+    bool framelessOnCreate() const;
+    void setFramelessOnCreate(const bool val);
+
 public Q_SLOTS:
     void removeWindowFrame(const bool center = true);
     void moveWindowToDesktopCenter();
@@ -117,9 +132,20 @@ Q_SIGNALS:
     void minimumSizeChanged(const QSize &);
     void maximumSizeChanged(const QSize &);
     void titleBarEnabledChanged(bool);
+    void framelessOnCreateChanged(bool);
+
+protected:
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
 
 private:
+    bool m_framelessOnCreate = false;
+
 #ifndef Q_OS_WINDOWS
-    FramelessHelper m_framelessHelper;
+    void attachToWindow(QQuickWindow *window);
+
+    // All helpers that live in the same window share one engine, see
+    // attachToWindow().
+    QQuickWindow *m_attachedWindow = nullptr;
+    FramelessHelper *m_framelessHelper = nullptr;
 #endif
 };
@@ -0,0 +1,194 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "framelessregionchannel.h"
+
+#include <QThread>
+#include <atomic>
+
+namespace {
+
+// Processes built with a different layout of the segment don't read each
+// other's regions, change it together with the layout.
+const quint32 m_magic = 0x464C4801;
+// Don't spin if the writer died while writing, keep the last regions.
+const int m_maximumReadAttempts = 16;
+// The writer may be started after the reader, don't try to attach on every
+// hit-test until it is.
+const int m_attachInterval = 1000;
+
+using SHAREDAREA = struct _SHAREDAREA {
+    std::atomic<qint32> x, y, width, height;
+};
+
+// The shared segment, the draggable areas come first. Every field is
+// atomic, the reader may read it while the writer writes it.
+using SHAREDREGIONS = struct _SHAREDREGIONS {
+    std::atomic<quint32> magic, sequence;
+    std::atomic<qint32> draggableCount, ignoreCount;
+    SHAREDAREA areas[FramelessRegionChannel::maximumAreaCount];
+};
+
+// Atomics which need a lock don't work across processes.
+static_assert(std::atomic<quint32>::is_always_lock_free &&
+                  std::atomic<qint32>::is_always_lock_free,
+              "The region channel needs lock-free 32-bit atomics.");
+
+void writeArea(SHAREDAREA &area, const QRect &rect) {
+    area.x.store(rect.x(), std::memory_order_relaxed);
+    area.y.store(rect.y(), std::memory_order_relaxed);
+    area.width.store(rect.width(), std::memory_order_relaxed);
+    area.height.store(rect.height(), std::memory_order_relaxed);
+}
+
+QRect readArea(const SHAREDAREA &area) {
+    return {area.x.load(std::memory_order_relaxed),
+            area.y.load(std::memory_order_relaxed),
+            area.width.load(std::memory_order_relaxed),
+            area.height.load(std::memory_order_relaxed)};
+}
+
+} // namespace
+
+FramelessRegionChannel::FramelessRegionChannel(const QString &key)
+    : m_memory(key) {}
+
+QString FramelessRegionChannel::getKey() const { return m_memory.key(); }
+
+QString FramelessRegionChannel::errorString() const {
+    return m_memory.errorString();
+}
+
+bool FramelessRegionChannel::attach(const bool writer) {
+    if (m_memory.isAttached()) {
+        return true;
+    }
+    if (writer) {
+        if (m_memory.create(sizeof(SHAREDREGIONS))) {
+            return true;
+        }
+        // System V shared memory outlives a writer which crashed, reuse it.
+        if ((m_memory.error() != QSharedMemory::AlreadyExists) ||
+            !m_memory.attach(QSharedMemory::ReadWrite)) {
+            return false;
+        }
+    } else {
+        if (m_attachTimer.isValid() &&
+            !m_attachTimer.hasExpired(m_attachInterval)) {
+            return false;
+        }
+        m_attachTimer.start();
+        if (!m_memory.attach(QSharedMemory::ReadOnly)) {
+            return false;
+        }
+    }
+    if (m_memory.size() < static_cast<int>(sizeof(SHAREDREGIONS))) {
+        m_memory.detach();
+        return false;
+    }
+    return true;
+}
+
+bool FramelessRegionChannel::publish(const REGIONS &regions) {
+    if (!attach(true)) {
+        return false;
+    }
+    const auto shared = static_cast<SHAREDREGIONS *>(m_memory.data());
+    // Odd while writing. It may be odd already if the previous writer
+    // crashed while writing.
+    quint32 sequence = shared->sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1u) == 0) {
+        ++sequence;
+    }
+    shared->sequence.store(sequence, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const int draggableCount =
+        qMin(regions.draggableAreas.size(), maximumAreaCount);
+    const int ignoreCount = qMin(regions.ignoreAreas.size(),
+                                 maximumAreaCount - draggableCount);
+    for (int i = 0; i != draggableCount; ++i) {
+        writeArea(shared->areas[i], regions.draggableAreas.at(i));
+    }
+    for (int i = 0; i != ignoreCount; ++i) {
+        writeArea(shared->areas[draggableCount + i],
+                  regions.ignoreAreas.at(i));
+    }
+    shared->draggableCount.store(draggableCount, std::memory_order_relaxed);
+    shared->ignoreCount.store(ignoreCount, std::memory_order_relaxed);
+    shared->magic.store(m_magic, std::memory_order_relaxed);
+    shared->sequence.store(sequence + 1, std::memory_order_release);
+    return true;
+}
+
+FramelessRegionChannel::REGIONS FramelessRegionChannel::read() {
+    if (!attach(false)) {
+        return m_regions;
+    }
+    const auto shared =
+        static_cast<const SHAREDREGIONS *>(m_memory.constData());
+    for (int attempt = 0; attempt != m_maximumReadAttempts; ++attempt) {
+        const quint32 sequence =
+            shared->sequence.load(std::memory_order_acquire);
+        if (sequence & 1u) {
+            // The writer is writing right now.
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        if (m_valid && (sequence == m_sequence)) {
+            return m_regions;
+        }
+        // Zero until the first publish().
+        const bool published =
+            (shared->magic.load(std::memory_order_relaxed) == m_magic);
+        const int draggableCount = published
+            ? qBound(0, shared->draggableCount.load(std::memory_order_relaxed),
+                     maximumAreaCount)
+            : 0;
+        const int ignoreCount = published
+            ? qBound(0, shared->ignoreCount.load(std::memory_order_relaxed),
+                     maximumAreaCount - draggableCount)
+            : 0;
+        REGIONS regions = {};
+        regions.draggableAreas.reserve(draggableCount);
+        regions.ignoreAreas.reserve(ignoreCount);
+        for (int i = 0; i != draggableCount; ++i) {
+            regions.draggableAreas.append(readArea(shared->areas[i]));
+        }
+        for (int i = 0; i != ignoreCount; ++i) {
+            regions.ignoreAreas.append(
+                readArea(shared->areas[draggableCount + i]));
+        }
+        // Everything above must be read before the sequence number is
+        // checked again.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (shared->sequence.load(std::memory_order_relaxed) == sequence) {
+            m_valid = true;
+            m_sequence = sequence;
+            m_regions = regions;
+            return m_regions;
+        }
+    }
+    return m_regions;
+}
@@ -0,0 +1,86 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QRect>
+#include <QSharedMemory>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// Hit regions of a window rendered by another process, shared through a
+// shared memory segment, for windows embedded into a frameless window with
+// QWindow::fromWinId() and QWidget::createWindowContainer().
+//
+// The embedding process (the reader, see
+// FramelessHelper::setRegionChannel()) reads the regions on every hit-test
+// without any IPC and without locking: the segment is protected by a
+// sequence lock, the embedded process (the only writer) makes the sequence
+// number odd while it writes, and the reader retries (or keeps the last
+// regions it has read) if the number is odd or has changed while it read.
+// Both processes must use the same key. The areas are in device independent
+// pixels of the embedded window.
+class FramelessRegionChannel {
+    Q_DISABLE_COPY_MOVE(FramelessRegionChannel)
+
+public:
+    using REGIONS = struct _REGIONS {
+        // The areas the window can be dragged with, such as a title bar
+        // drawn by the embedded process, and the areas which must neither
+        // drag nor resize the window, such as it's buttons.
+        QVector<QRect> draggableAreas = {}, ignoreAreas = {};
+    };
+
+    // The maximum count of all areas, the rest is dropped.
+    static constexpr int maximumAreaCount = 64;
+
+    explicit FramelessRegionChannel(const QString &key);
+    ~FramelessRegionChannel() = default;
+
+    QString getKey() const;
+
+    // Writer: create the segment (or attach to a stale one) and publish the
+    // regions, call it whenever they change.
+    bool publish(const REGIONS &regions);
+
+    // Reader: the last consistent regions, empty until the writer has
+    // published any. Cheap if nothing changed since the last call.
+    REGIONS read();
+
+    QString errorString() const;
+
+private:
+    bool attach(const bool writer);
+
+    QSharedMemory m_memory;
+    // Reader: the regions of the last sequence number read, and when we
+    // tried to attach the last time, the writer may not be running yet.
+    bool m_valid = false;
+    quint32 m_sequence = 0;
+    REGIONS m_regions = {};
+    QElapsedTimer m_attachTimer = {};
+};
@@ -4,6 +4,7 @@
 #include <QLabel>
 #include <QPushButton>
 #ifdef QT_QUICK_LIB
+#include "framelessbuttonicons.h"
 #include "framelessquickhelper.h"
 #include <QQmlApplicationEngine>
 #endif
@@ -97,6 +98,9 @@ int main(int argc, char *argv[]) {
     QQmlApplicationEngine engine;
     qmlRegisterType<FramelessQuickHelper>("wangwenx190.Utils", 1, 0,
                                           "FramelessHelper");
+    // The engine takes ownership of the image provider.
+    engine.addImageProvider(QString::fromUtf8("framelessbuttons"),
+                            new FramelessButtonImageProvider);
     const QUrl mainQmlUrl(QString::fromUtf8("qrc:///qml/main.qml"));
     const QMetaObject::Connection connection = QObject::connect(
         &engine, &QQmlApplicationEngine::objectCreated, &application,
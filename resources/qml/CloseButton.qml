@@ -1,5 +1,6 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
+import QtQuick.Window 2.15
 
 Button {
     id: button
@@ -7,14 +8,28 @@ Button {
     width: 45
     height: 30
 
+    property bool darkTheme: false
+
     ToolTip.visible: hovered && !down
     ToolTip.delay: Qt.styleHints.mousePressAndHoldInterval
     ToolTip.text: qsTr("Close")
 
     contentItem: Image {
+        // The cached glyphs of FramelessButtonImageProvider, or the SVG files
+        // if the application didn't register the provider.
+        property bool providerMissing: false
+        readonly property string glyph: button.down || button.hovered
+                                        || button.darkTheme ? "close_white" : "close_black"
         anchors.fill: parent
-        source: button.down
-                || button.hovered ? "qrc:/images/button_close_white.svg" : "qrc:/images/button_close_black.svg"
+        sourceSize: Qt.size(button.width * Screen.devicePixelRatio,
+                            button.height * Screen.devicePixelRatio)
+        source: providerMissing ? "qrc:/images/button_" + glyph + ".svg"
+                                : "image://framelessbuttons/" + glyph
+        onStatusChanged: {
+            if ((status === Image.Error) && !providerMissing) {
+                providerMissing = true
+            }
+        }
     }
 
     background: Rectangle {
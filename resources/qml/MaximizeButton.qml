@@ -1,5 +1,6 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
+import QtQuick.Window 2.15
 
 Button {
     id: button
@@ -8,14 +9,28 @@ Button {
     height: 30
 
     property bool maximized: false
+    property bool darkTheme: false
 
     ToolTip.visible: hovered && !down
     ToolTip.delay: Qt.styleHints.mousePressAndHoldInterval
     ToolTip.text: maximized ? qsTr("Restore") : qsTr("Maximize")
 
     contentItem: Image {
+        // The cached glyphs of FramelessButtonImageProvider, or the SVG files
+        // if the application didn't register the provider.
+        property bool providerMissing: false
+        readonly property string glyph: (button.maximized ? "restore" : "maximize")
+                                        + (button.darkTheme ? "_white" : "_black")
         anchors.fill: parent
-        source: maximized ? "qrc:/images/button_restore_black.svg" : "qrc:/images/button_maximize_black.svg"
+        sourceSize: Qt.size(button.width * Screen.devicePixelRatio,
+                            button.height * Screen.devicePixelRatio)
+        source: providerMissing ? "qrc:/images/button_" + glyph + ".svg"
+                                : "image://framelessbuttons/" + glyph
+        onStatusChanged: {
+            if ((status === Image.Error) && !providerMissing) {
+                providerMissing = true
+            }
+        }
     }
 
     background: Rectangle {
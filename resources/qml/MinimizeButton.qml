@@ -1,5 +1,6 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
+import QtQuick.Window 2.15
 
 Button {
     id: button
@@ -7,13 +8,27 @@ Button {
     width: 45
     height: 30
 
+    property bool darkTheme: false
+
     ToolTip.visible: hovered && !down
     ToolTip.delay: Qt.styleHints.mousePressAndHoldInterval
     ToolTip.text: qsTr("Minimize")
 
     contentItem: Image {
+        // The cached glyphs of FramelessButtonImageProvider, or the SVG files
+        // if the application didn't register the provider.
+        property bool providerMissing: false
+        readonly property string glyph: button.darkTheme ? "minimize_white" : "minimize_black"
         anchors.fill: parent
-        source: "qrc:/images/button_minimize_black.svg"
+        sourceSize: Qt.size(button.width * Screen.devicePixelRatio,
+                            button.height * Screen.devicePixelRatio)
+        source: providerMissing ? "qrc:/images/button_" + glyph + ".svg"
+                                : "image://framelessbuttons/" + glyph
+        onStatusChanged: {
+            if ((status === Image.Error) && !providerMissing) {
+                providerMissing = true
+            }
+        }
     }
 
     background: Rectangle {
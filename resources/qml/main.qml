@@ -11,6 +11,7 @@ Window {
 
     FramelessHelper {
         id: framelessHelper
+        framelessOnCreate: true
         Component.onCompleted: framelessHelper.removeWindowFrame()
     }
 
@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "symbolresolver.h"
+
+#include <QHash>
+#include <QLibrary>
+#include <QSharedPointer>
+
+namespace {
+
+// All the libraries loaded so far, the key is the name and the version.
+QHash<QString, QSharedPointer<QLibrary>> m_libraries;
+
+// Functions replaced by setOverride(), the key is the library and the
+// symbol.
+QHash<QString, QFunctionPointer> m_overrides;
+
+QString getOverrideKey(const QString &library, const char *symbol) {
+    return library + QLatin1Char('!') + QString::fromUtf8(symbol);
+}
+
+QString getLibraryKey(const QString &library, const int version) {
+    return (version < 0)
+        ? library
+        : QString::fromUtf8("%1.%2").arg(library, QString::number(version));
+}
+
+QLibrary *getLibrary(const QString &library, const int version) {
+    const QString key = getLibraryKey(library, version);
+    const auto it = m_libraries.constFind(key);
+    if (it != m_libraries.constEnd()) {
+        return it->data();
+    }
+    QSharedPointer<QLibrary> lib = (version < 0)
+        ? QSharedPointer<QLibrary>::create(library)
+        : QSharedPointer<QLibrary>::create(library, version);
+    // Try only once, a missing library doesn't appear later.
+    lib->load();
+    m_libraries.insert(key, lib);
+    return lib.data();
+}
+
+} // namespace
+
+QFunctionPointer SymbolResolver::resolve(const QString &library,
+                                         const int version,
+                                         const char *symbol) {
+    if (library.isEmpty() || !symbol) {
+        return nullptr;
+    }
+    if (!m_overrides.isEmpty()) {
+        const auto it = m_overrides.constFind(getOverrideKey(library, symbol));
+        if (it != m_overrides.constEnd()) {
+            return *it;
+        }
+    }
+    QLibrary *const lib = getLibrary(library, version);
+    return lib->isLoaded() ? lib->resolve(symbol) : nullptr;
+}
+
+QString SymbolResolver::errorString(const QString &library,
+                                    const int version) {
+    return getLibrary(library, version)->errorString();
+}
+
+void SymbolResolver::setOverride(const QString &library, const char *symbol,
+                                 QFunctionPointer function) {
+    if (library.isEmpty() || !symbol) {
+        return;
+    }
+    const QString key = getOverrideKey(library, symbol);
+    if (function) {
+        m_overrides.insert(key, function);
+    } else {
+        m_overrides.remove(key);
+    }
+}
+
+void SymbolResolver::clearOverrides() { m_overrides.clear(); }
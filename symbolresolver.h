@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QDebug>
+#include <QString>
+#include <QtGlobal>
+#include <utility>
+
+// Resolves functions of system libraries at run-time, so we don't have to
+// link against them and can still run if they (or some of their functions)
+// are missing. Every library is loaded only once and shared by all the
+// symbols resolved from it. Only use it from the GUI thread.
+class SymbolResolver {
+    Q_DISABLE_COPY_MOVE(SymbolResolver)
+
+public:
+    SymbolResolver() = delete;
+
+    // Pass a negative version to load the library without a version number
+    // ("libxcb.so" instead of "libxcb.so.1"), always do so on Windows.
+    static QFunctionPointer resolve(const QString &library, const int version,
+                                    const char *symbol);
+    static QString errorString(const QString &library, const int version);
+
+    // Replace a function of a library with another implementation, a fake
+    // of the Win32 API for example, to run the code which uses it without
+    // the real library. resolve() returns the override for every version of
+    // the library and doesn't even load it. Install the overrides before the
+    // functions are resolved for the first time, the users keep what they
+    // resolved. A null function removes the override.
+    static void setOverride(const QString &library, const char *symbol,
+                            QFunctionPointer function);
+    static void clearOverrides();
+};
+
+// A function of a system library which is resolved the first time it's
+// used. Declare it with FLH_GENERATE_SYMBOL and call it like the function
+// itself, after checking isAvailable() if the library or the function is
+// optional. Calling a function which couldn't be resolved does nothing but
+// print a warning (once) and returns a value initialized result, such as
+// zero or nullptr.
+template <typename T>
+class LazySymbol;
+
+template <typename R, typename... Args>
+class LazySymbol<R(Args...)> {
+    Q_DISABLE_COPY_MOVE(LazySymbol)
+
+public:
+    using Function = R (*)(Args...);
+
+    explicit constexpr LazySymbol(const char *library, const int version,
+                                  const char *symbol)
+        : m_library(library), m_version(version), m_symbol(symbol) {}
+    ~LazySymbol() = default;
+
+    bool isAvailable() const { return get() != nullptr; }
+
+    template <typename... CallArgs>
+    R operator()(CallArgs &&... args) const {
+        const Function function = get();
+        if (!function) {
+            if (!m_warned) {
+                m_warned = true;
+                qWarning().noquote()
+                    << "Failed to resolve" << m_symbol << "from" << m_library
+                    << ':'
+                    << SymbolResolver::errorString(
+                           QString::fromUtf8(m_library), m_version);
+            }
+            return R();
+        }
+        return function(std::forward<CallArgs>(args)...);
+    }
+
+private:
+    Function get() const {
+        if (!m_resolved) {
+            m_resolved = true;
+            m_function = reinterpret_cast<Function>(SymbolResolver::resolve(
+                QString::fromUtf8(m_library), m_version, m_symbol));
+        }
+        return m_function;
+    }
+
+    const char *m_library = nullptr;
+    int m_version = -1;
+    const char *m_symbol = nullptr;
+    mutable bool m_resolved = false, m_warned = false;
+    mutable Function m_function = nullptr;
+};
+
+// Declares m_lp<funcName>, with the signature of the declaration of the
+// function in its header.
+#ifndef FLH_GENERATE_SYMBOL
+#define FLH_GENERATE_SYMBOL(libName, libVersion, funcName)                     \
+    LazySymbol<decltype(funcName)> m_lp##funcName(#libName, libVersion,        \
+                                                  #funcName);
+#endif
@@ -0,0 +1,4 @@
+TARGET = tst_background
+TEMPLATE = app
+include(../tests.pri)
+SOURCES += tst_background.cpp
@@ -0,0 +1,148 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// Counts the pixels of the area a resize exposes that don't have the colour
+// of the content, with and without setBackgroundColor(). The content follows
+// the size of the window with a delay, like the layout of a heavy window,
+// and the window is captured from the X server after every resize step, so
+// the capture shows what the user sees before the content caught up. Needs
+// the xcb platform, run it under Xvfb without a compositor.
+
+#include "framelesshelper.h"
+#include <QGuiApplication>
+#include <QPainter>
+#include <QScreen>
+#include <QTimer>
+#include <QWidget>
+#include <QtTest>
+
+namespace {
+
+const QColor m_contentColor = QColor(0x20, 0x20, 0x30);
+const int m_steps = 20;
+const int m_stepSize = 15;
+// Longer than the time we wait before the capture.
+const int m_layoutDelay = 100;
+
+// Paints the content colour, but only over the area it has been laid out
+// for.
+class LateContent : public QWidget {
+public:
+    explicit LateContent(QWidget *parent) : QWidget(parent) {}
+
+protected:
+    void paintEvent(QPaintEvent *event) override {
+        Q_UNUSED(event)
+        QPainter painter(this);
+        painter.fillRect(rect(), m_contentColor);
+    }
+};
+
+class LateWindow : public QWidget {
+public:
+    LateWindow() : m_content(new LateContent(this)) {}
+
+protected:
+    void resizeEvent(QResizeEvent *event) override {
+        QWidget::resizeEvent(event);
+        QTimer::singleShot(m_layoutDelay, m_content,
+                           [this]() { m_content->resize(size()); });
+    }
+
+private:
+    LateContent *m_content = nullptr;
+};
+
+} // namespace
+
+class BackgroundTest : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void exposedArea();
+
+private:
+    // Returns the number of wrong colour pixels over all resize steps.
+    int resizeAndCount(const bool backgroundColor) const;
+};
+
+void BackgroundTest::initTestCase() {
+    if (QGuiApplication::platformName() != QStringLiteral("xcb")) {
+        QSKIP("The capture needs the xcb platform (Xvfb).");
+    }
+}
+
+void BackgroundTest::exposedArea() {
+    const int without = resizeAndCount(false);
+    const int with = resizeAndCount(true);
+    qInfo("Wrong colour pixels in %d resize steps: %d without and %d with "
+          "setBackgroundColor()",
+          m_steps, without, with);
+    QVERIFY((without >= 0) && (with >= 0));
+    QVERIFY(with < without);
+}
+
+int BackgroundTest::resizeAndCount(const bool backgroundColor) const {
+    FramelessHelper helper;
+    LateWindow window;
+    helper.removeWindowFrame(&window);
+    if (backgroundColor) {
+        helper.setBackgroundColor(&window, m_contentColor);
+    }
+    window.setGeometry(100, 100, 300, 200);
+    window.show();
+    if (!QTest::qWaitForWindowExposed(&window)) {
+        return -1;
+    }
+    // Let the content catch up with the initial size.
+    QTest::qWait(m_layoutDelay * 2);
+    QScreen *const screen = window.screen();
+    const QRgb content = m_contentColor.rgb();
+    int wrongPixels = 0;
+    for (int i = 1; i <= m_steps; ++i) {
+        window.resize(300 + (i * m_stepSize), 200 + (i * m_stepSize));
+        // Enough for the expose and the flush, not for the late layout.
+        QTest::qWait(m_layoutDelay / 4);
+        const QImage image =
+            screen->grabWindow(window.winId()).toImage().convertToFormat(
+                QImage::Format_RGB32);
+        for (int y = 0; y != image.height(); ++y) {
+            const auto line = reinterpret_cast<const QRgb *>(image.scanLine(y));
+            for (int x = 0; x != image.width(); ++x) {
+                if (qRgb(qRed(line[x]), qGreen(line[x]), qBlue(line[x])) !=
+                    content) {
+                    ++wrongPixels;
+                }
+            }
+        }
+        QTest::qWait(m_layoutDelay * 2);
+    }
+    return wrongPixels;
+}
+
+QTEST_MAIN(BackgroundTest)
+
+#include "tst_background.moc"
@@ -0,0 +1,4 @@
+TARGET = tst_manualgrab
+TEMPLATE = app
+include(../tests.pri)
+SOURCES += tst_manualgrab.cpp
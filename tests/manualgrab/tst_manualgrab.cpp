@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// The client driven move/resize, used when the platform can't move or resize
+// the window for us. Runs on the offscreen platform by default, run it with
+// QT_QPA_PLATFORM=xcb under a bare Xvfb (no window manager) to check the X11
+// side.
+
+#include "framelesshelper.h"
+#include <QRasterWindow>
+#include <QtTest>
+
+class ManualGrabTest : public QObject {
+    Q_OBJECT
+
+public:
+    static void initMain() {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void move();
+    void resize();
+    void minimumSize();
+
+private:
+    FramelessHelper *m_helper = nullptr;
+    QRasterWindow *m_window = nullptr;
+};
+
+void ManualGrabTest::init() {
+    m_helper = new FramelessHelper;
+    m_window = new QRasterWindow;
+    m_helper->removeWindowFrame(m_window);
+    m_window->setGeometry(200, 200, 400, 300);
+    m_window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_window));
+}
+
+void ManualGrabTest::cleanup() {
+    delete m_window;
+    m_window = nullptr;
+    delete m_helper;
+    m_helper = nullptr;
+}
+
+void ManualGrabTest::move() {
+    const QPoint start = m_window->position();
+    // Inside the title bar, away from the resize borders.
+    const QPoint pressPos = {200, 15};
+    QTest::mousePress(m_window, Qt::LeftButton, {}, pressPos);
+    QTest::mouseMove(m_window, pressPos + QPoint(20, 10));
+    QTest::mouseMove(m_window, pressPos + QPoint(50, 30));
+    // The geometry is applied once per frame, not per motion event.
+    QTRY_COMPARE(m_window->position(), start + QPoint(50, 30));
+    QCOMPARE(m_window->size(), QSize(400, 300));
+    QTest::mouseRelease(m_window, Qt::LeftButton, {},
+                        pressPos + QPoint(50, 30));
+}
+
+void ManualGrabTest::resize() {
+    const QPoint start = m_window->position();
+    // On the right border.
+    const QPoint pressPos = {m_window->width() - 2, 150};
+    QTest::mousePress(m_window, Qt::LeftButton, {}, pressPos);
+    QTest::mouseMove(m_window, pressPos + QPoint(40, 0));
+    QTRY_COMPARE(m_window->width(), 440);
+    QCOMPARE(m_window->height(), 300);
+    QCOMPARE(m_window->position(), start);
+    QTest::mouseRelease(m_window, Qt::LeftButton, {},
+                        pressPos + QPoint(40, 0));
+}
+
+void ManualGrabTest::minimumSize() {
+    m_window->setMinimumSize({350, 250});
+    // On the bottom right corner.
+    const QPoint pressPos = {m_window->width() - 2, m_window->height() - 2};
+    QTest::mousePress(m_window, Qt::LeftButton, {}, pressPos);
+    QTest::mouseMove(m_window, pressPos - QPoint(200, 200));
+    QTRY_COMPARE(m_window->size(), QSize(350, 250));
+    QTest::mouseRelease(m_window, Qt::LeftButton, {},
+                        pressPos - QPoint(200, 200));
+}
+
+QTEST_MAIN(ManualGrabTest)
+
+#include "tst_manualgrab.moc"
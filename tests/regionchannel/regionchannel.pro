@@ -0,0 +1,4 @@
+TARGET = tst_regionchannel
+TEMPLATE = app
+include(../tests.pri)
+SOURCES += tst_regionchannel.cpp
@@ -0,0 +1,255 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// The region channel between two processes: the test starts itself again as
+// the writer and reads what the writer publishes.
+
+#include "framelessregionchannel.h"
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QTextStream>
+#include <QtTest>
+
+namespace {
+
+const int m_timeout = 5000;
+const int m_spinDuration = 1000;
+
+// Every set agrees with itself, a torn read mixes two of them.
+FramelessRegionChannel::REGIONS makeRegions(const int serial) {
+    FramelessRegionChannel::REGIONS regions = {};
+    const int count = (serial % 32) + 1;
+    for (int i = 0; i != count; ++i) {
+        regions.draggableAreas.append({serial, i, 10, 10});
+    }
+    regions.ignoreAreas.append({0, serial, 10, 10});
+    return regions;
+}
+
+bool isConsistent(const FramelessRegionChannel::REGIONS &regions) {
+    if (regions.draggableAreas.isEmpty() ||
+        (regions.ignoreAreas.size() != 1)) {
+        return false;
+    }
+    const int serial = regions.draggableAreas.first().x();
+    return (regions.draggableAreas == makeRegions(serial).draggableAreas) &&
+        (regions.ignoreAreas == makeRegions(serial).ignoreAreas);
+}
+
+bool isEqual(const FramelessRegionChannel::REGIONS &lhs,
+             const FramelessRegionChannel::REGIONS &rhs) {
+    return (lhs.draggableAreas == rhs.draggableAreas) &&
+        (lhs.ignoreAreas == rhs.ignoreAreas);
+}
+
+// The writer side, one command per line on stdin, one reply per line on
+// stdout:
+//   publish <serial>  publishes makeRegions(serial)
+//   spin <ms>         publishes increasing serials for that long
+//   quit
+int runWriter(const QString &key) {
+    FramelessRegionChannel channel(key);
+    QTextStream input(stdin);
+    QTextStream output(stdout);
+    while (true) {
+        const QStringList command =
+            input.readLine().split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        if (command.isEmpty() ||
+            (command.first() == QString::fromUtf8("quit"))) {
+            return 0;
+        }
+        bool ok = command.size() == 2;
+        const int value = ok ? command.at(1).toInt(&ok) : 0;
+        if (ok && (command.first() == QString::fromUtf8("publish"))) {
+            ok = channel.publish(makeRegions(value));
+        } else if (ok && (command.first() == QString::fromUtf8("spin"))) {
+            QElapsedTimer timer;
+            timer.start();
+            for (int serial = 0; ok && !timer.hasExpired(value); ++serial) {
+                ok = channel.publish(makeRegions(serial));
+            }
+        } else {
+            ok = false;
+        }
+        output << (ok ? "ok" : "error") << Qt::endl;
+    }
+}
+
+class Writer {
+public:
+    explicit Writer(const QString &key) {
+        m_process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        m_process.start(QCoreApplication::applicationFilePath(),
+                        {QString::fromUtf8("-writer"), key});
+    }
+
+    ~Writer() {
+        if (m_process.state() != QProcess::NotRunning) {
+            m_process.write("quit\n");
+            if (!m_process.waitForFinished(m_timeout)) {
+                m_process.kill();
+                m_process.waitForFinished(m_timeout);
+            }
+        }
+    }
+
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+
+    void send(const QByteArray &command) {
+        m_process.write(command + '\n');
+    }
+
+    QByteArray reply() {
+        while (!m_process.canReadLine()) {
+            if (!m_process.waitForReadyRead(m_timeout)) {
+                return {};
+            }
+        }
+        return m_process.readLine().trimmed();
+    }
+
+    bool command(const QByteArray &command) {
+        send(command);
+        return reply() == "ok";
+    }
+
+    void kill() {
+        m_process.kill();
+        m_process.waitForFinished(m_timeout);
+    }
+
+private:
+    QProcess m_process;
+};
+
+} // namespace
+
+class RegionChannelTest : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void readerStartedFirst();
+    void publishAndRead();
+    void consistentWhileWriting();
+    void restartedWriter();
+
+private:
+    QString m_key = {};
+};
+
+void RegionChannelTest::init() {
+    // Unique per test function, a segment left behind by an earlier test
+    // must not decide the result of the next one.
+    m_key = QString::fromUtf8("flh-tst-regionchannel-%1-%2")
+                .arg(QCoreApplication::applicationPid())
+                .arg(QString::fromUtf8(QTest::currentTestFunction()));
+}
+
+void RegionChannelTest::readerStartedFirst() {
+    FramelessRegionChannel reader(m_key);
+    // Nothing to attach to yet.
+    QVERIFY(reader.read().draggableAreas.isEmpty());
+    Writer writer(m_key);
+    QVERIFY(writer.command("publish 4"));
+    // The reader retries attaching about once a second.
+    QTRY_VERIFY_WITH_TIMEOUT(isEqual(reader.read(), makeRegions(4)),
+                             m_timeout);
+}
+
+void RegionChannelTest::publishAndRead() {
+    Writer writer(m_key);
+    QVERIFY(writer.command("publish 5"));
+    FramelessRegionChannel reader(m_key);
+    QVERIFY(isEqual(reader.read(), makeRegions(5)));
+    QVERIFY(writer.command("publish 40"));
+    QVERIFY(isEqual(reader.read(), makeRegions(40)));
+    // Unchanged regions are returned from the reader's copy.
+    QVERIFY(isEqual(reader.read(), makeRegions(40)));
+}
+
+void RegionChannelTest::consistentWhileWriting() {
+    Writer writer(m_key);
+    QVERIFY(writer.command("publish 0"));
+    FramelessRegionChannel reader(m_key);
+    QVERIFY(isEqual(reader.read(), makeRegions(0)));
+    writer.send("spin " + QByteArray::number(m_spinDuration));
+    QElapsedTimer timer;
+    timer.start();
+    int reads = 0;
+    int lastSerial = 0;
+    int changes = 0;
+    while (!timer.hasExpired(m_spinDuration)) {
+        const FramelessRegionChannel::REGIONS regions = reader.read();
+        QVERIFY2(isConsistent(regions),
+                 qPrintable(QString::fromUtf8("Torn read after %1 reads.")
+                                .arg(reads)));
+        const int serial = regions.draggableAreas.first().x();
+        // The writer only counts up.
+        QVERIFY(serial >= lastSerial);
+        if (serial != lastSerial) {
+            ++changes;
+        }
+        lastSerial = serial;
+        ++reads;
+    }
+    QCOMPARE(writer.reply(), QByteArray("ok"));
+    // Otherwise the loop above didn't overlap with the writer at all.
+    QVERIFY(changes > 1);
+    qDebug().noquote() << QString::fromUtf8("%1 reads, %2 changes seen.")
+                              .arg(reads)
+                              .arg(changes);
+}
+
+void RegionChannelTest::restartedWriter() {
+    FramelessRegionChannel reader(m_key);
+    {
+        Writer writer(m_key);
+        QVERIFY(writer.command("publish 3"));
+        QTRY_VERIFY_WITH_TIMEOUT(isEqual(reader.read(), makeRegions(3)),
+                                 m_timeout);
+        // Like a crash, the segment stays behind.
+        writer.kill();
+    }
+    // The last regions stay valid while no writer runs.
+    QVERIFY(isEqual(reader.read(), makeRegions(3)));
+    Writer writer(m_key);
+    QVERIFY(writer.command("publish 9"));
+    QVERIFY(isEqual(reader.read(), makeRegions(9)));
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication application(argc, argv);
+    const QStringList arguments = QCoreApplication::arguments();
+    if ((arguments.size() == 3) &&
+        (arguments.at(1) == QString::fromUtf8("-writer"))) {
+        return runWriter(arguments.at(2));
+    }
+    RegionChannelTest test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_regionchannel.moc"
@@ -0,0 +1,7 @@
+# Shared by the tests: builds FramelessHelper from the sources in the parent
+# directory.
+win32: include($$PWD/../framelesshelper_windows.pri)
+else: include($$PWD/../framelesshelper_unix.pri)
+QT += testlib
+CONFIG += console testcase
+CONFIG -= app_bundle
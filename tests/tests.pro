@@ -0,0 +1,15 @@
+TEMPLATE = subdirs
+# The client driven move/resize (offscreen, or xcb under a bare Xvfb).
+!win32: SUBDIRS += manualgrab
+# The colour of the area a resize exposes (xcb under Xvfb, skipped elsewhere).
+!win32:qtHaveModule(widgets): SUBDIRS += background
+# One system move/resize per touch gesture (offscreen).
+!win32: SUBDIRS += touchgesture
+# The region channel between a writer and a reader process.
+!win32: SUBDIRS += regionchannel
+# The message handling of WinNativeEventFilter, on a fake of the Win32 API
+# (every platform).
+SUBDIRS += winnativeeventfilter
+# The same on a fake which pretends to be Windows 7 (elsewhere than on Windows,
+# there the filter asks Qt for the version).
+!win32: SUBDIRS += windows7
@@ -0,0 +1,4 @@
+TARGET = tst_touchgesture
+TEMPLATE = app
+include(../tests.pri)
+SOURCES += tst_touchgesture.cpp
@@ -0,0 +1,135 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// The touch gestures of a frameless window: however many touch events a drag
+// consists of, it must request exactly one system move/resize, and a tap none
+// at all. Qt synthesizes mouse events from the touch events nobody accepted,
+// those must not start anything either. Runs on the offscreen platform by
+// default.
+
+#include "framelesshelper.h"
+#include <QRasterWindow>
+#include <QtTest>
+
+class TouchGestureTest : public QObject {
+    Q_OBJECT
+
+public:
+    static void initMain() {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void drag_data();
+    void drag();
+    void tap();
+
+private:
+    // Drag the finger from pos by offset, in steps of a few pixels.
+    void touchDrag(const QPoint &pos, const QPoint &offset);
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    QPointingDevice *m_device = nullptr;
+#else
+    QTouchDevice *m_device = nullptr;
+#endif
+    FramelessHelper *m_helper = nullptr;
+    QRasterWindow *m_window = nullptr;
+};
+
+void TouchGestureTest::initTestCase() {
+    m_device = QTest::createTouchDevice();
+    QVERIFY(m_device);
+}
+
+void TouchGestureTest::init() {
+    m_helper = new FramelessHelper;
+    m_window = new QRasterWindow;
+    m_helper->removeWindowFrame(m_window);
+    m_window->setGeometry(200, 200, 400, 300);
+    m_window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_window));
+}
+
+void TouchGestureTest::cleanup() {
+    delete m_window;
+    m_window = nullptr;
+    delete m_helper;
+    m_helper = nullptr;
+}
+
+void TouchGestureTest::touchDrag(const QPoint &pos, const QPoint &offset) {
+    QTest::touchEvent(m_window, m_device).press(0, pos);
+    const int steps = 10;
+    for (int i = 1; i <= steps; ++i) {
+        QTest::touchEvent(m_window, m_device)
+            .move(0, pos + ((offset * i) / steps));
+    }
+    QTest::touchEvent(m_window, m_device).release(0, pos + offset);
+}
+
+void TouchGestureTest::drag_data() {
+    QTest::addColumn<QPoint>("pos");
+    QTest::addColumn<QPoint>("offset");
+
+    // Inside the title bar, away from the resize borders.
+    QTest::newRow("move") << QPoint(200, 15) << QPoint(60, 40);
+    // On the right border.
+    QTest::newRow("resize") << QPoint(398, 150) << QPoint(60, 0);
+}
+
+void TouchGestureTest::drag() {
+    QFETCH(QPoint, pos);
+    QFETCH(QPoint, offset);
+
+    const int before = FramelessHelper::getSystemMoveResizeCount();
+    QTest::touchEvent(m_window, m_device).press(0, pos);
+    // Still within the drag distance: nothing has started yet, neither by
+    // the touch press nor by the mouse press Qt synthesized from it.
+    QTest::touchEvent(m_window, m_device).move(0, pos + QPoint(2, 1));
+    QCOMPARE(FramelessHelper::getSystemMoveResizeCount(), before);
+    QTest::touchEvent(m_window, m_device).release(0, pos + QPoint(2, 1));
+
+    touchDrag(pos, offset);
+    QCOMPARE(FramelessHelper::getSystemMoveResizeCount(), before + 1);
+    // The next gesture gets it's own one.
+    touchDrag(pos, offset);
+    QCOMPARE(FramelessHelper::getSystemMoveResizeCount(), before + 2);
+}
+
+void TouchGestureTest::tap() {
+    const int before = FramelessHelper::getSystemMoveResizeCount();
+    QTest::touchEvent(m_window, m_device).press(0, QPoint(200, 15));
+    QTest::touchEvent(m_window, m_device).release(0, QPoint(200, 15));
+    QCOMPARE(FramelessHelper::getSystemMoveResizeCount(), before);
+}
+
+QTEST_MAIN(TouchGestureTest)
+
+#include "tst_touchgesture.moc"
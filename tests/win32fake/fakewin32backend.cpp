@@ -0,0 +1,691 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "fakewin32backend.h"
+
+#include <cwchar>
+
+namespace {
+
+#ifndef SM_CXPADDEDBORDER
+// Only available since Windows Vista
+#define SM_CXPADDEDBORDER 92
+#endif
+
+#ifndef ABM_GETSTATE
+#define ABM_GETSTATE 0x00000004
+#endif
+
+#ifndef ABM_GETTASKBARPOS
+#define ABM_GETTASKBARPOS 0x00000005
+#endif
+
+#ifndef ABM_GETAUTOHIDEBAREX
+#define ABM_GETAUTOHIDEBAREX 0x0000000b
+#endif
+
+#ifndef ABS_AUTOHIDE
+#define ABS_AUTOHIDE 0x0000001
+#endif
+
+#ifndef ABS_ALWAYSONTOP
+#define ABS_ALWAYSONTOP 0x0000002
+#endif
+
+#ifndef ABE_LEFT
+#define ABE_LEFT 0
+#endif
+
+#ifndef ABE_TOP
+#define ABE_TOP 1
+#endif
+
+#ifndef ABE_RIGHT
+#define ABE_RIGHT 2
+#endif
+
+#ifndef ABE_BOTTOM
+#define ABE_BOTTOM 3
+#endif
+
+const UINT m_defaultDotsPerInch = 96;
+
+// The values of Windows 10 at 96 DPI.
+const int m_frameThickness = 4, m_paddedBorderThickness = 4,
+          m_captionHeight = 23;
+
+// The taskbar is this thick when it's visible.
+const int m_taskbarThickness = 40;
+
+const auto m_screenDC = reinterpret_cast<HDC>(quintptr(1));
+
+// The pseudo handle of Win32.
+const auto m_currentProcess = reinterpret_cast<HANDLE>(LONG_PTR(-1));
+
+int scaleForDpi(const int value, const UINT dpi) {
+    return qRound(value * static_cast<qreal>(dpi) / m_defaultDotsPerInch);
+}
+
+// GetSystemMetricsForDpi() and AdjustWindowRectExForDpi(), without counting
+// a call when the functions without "ForDpi" use them.
+int getSystemMetricForDpi(const int index, const UINT dpi) {
+    switch (index) {
+    case SM_CXSIZEFRAME:
+    case SM_CYSIZEFRAME:
+        return scaleForDpi(m_frameThickness, dpi);
+    case SM_CXPADDEDBORDER:
+        return scaleForDpi(m_paddedBorderThickness, dpi);
+    case SM_CYCAPTION:
+        return scaleForDpi(m_captionHeight, dpi);
+    default:
+        return 0;
+    }
+}
+
+BOOL adjustWindowRectForDpi(LPRECT rect, const DWORD style, const UINT dpi) {
+    if (!rect) {
+        return FALSE;
+    }
+    if (style & WS_THICKFRAME) {
+        const int frame = scaleForDpi(m_frameThickness, dpi) +
+            scaleForDpi(m_paddedBorderThickness, dpi);
+        rect->left -= frame;
+        rect->top -= frame;
+        rect->right += frame;
+        rect->bottom += frame;
+    }
+    if ((style & WS_CAPTION) == WS_CAPTION) {
+        rect->top -= scaleForDpi(m_captionHeight, dpi);
+    }
+    return TRUE;
+}
+
+RECT toRECT(const QRect &rect) {
+    return {rect.left(), rect.top(), rect.left() + rect.width(),
+            rect.top() + rect.height()};
+}
+
+HMONITOR toHMONITOR(const int index) {
+    return (index < 0) ? nullptr
+                       : reinterpret_cast<HMONITOR>(quintptr(index + 1));
+}
+
+int toMonitorIndex(const HMONITOR monitor) {
+    return static_cast<int>(reinterpret_cast<quintptr>(monitor)) - 1;
+}
+
+} // namespace
+
+FakeWin32Backend::FakeWin32Backend() { reset(); }
+
+void FakeWin32Backend::reset() {
+    m_monitors.clear();
+    m_windows.clear();
+    m_calls.clear();
+    m_nextWindow = 0;
+    setVersion(10, 0, 19041);
+    addMonitor({0, 0, 1920, 1080}, {0, 0, 1920, 1080 - m_taskbarThickness});
+    m_taskbarEdge = ABE_BOTTOM;
+    m_taskbarAutoHide = false;
+    m_desktop = createWindow(m_monitors.first().geometry, WS_POPUP);
+    m_taskbar = createWindow(getTaskbarGeometry(), WS_POPUP | WS_VISIBLE);
+}
+
+int FakeWin32Backend::addMonitor(const QRect &geometry, const QRect &workArea,
+                                 const UINT dotsPerInch) {
+    m_monitors.append({geometry, workArea, dotsPerInch});
+    return m_monitors.size() - 1;
+}
+
+void FakeWin32Backend::setVersion(const DWORD major, const DWORD minor,
+                                  const DWORD build) {
+    m_majorVersion = major;
+    m_minorVersion = minor;
+    m_buildNumber = build;
+}
+
+FakeWin32Backend::FAKEMONITOR *FakeWin32Backend::monitor(const int index) {
+    return ((index >= 0) && (index < m_monitors.size()))
+        ? &m_monitors[index]
+        : nullptr;
+}
+
+HWND FakeWin32Backend::createWindow(const QRect &geometry,
+                                    const LONG_PTR style, const HWND parent) {
+    // Like real handles: never null, multiples of four.
+    const auto hWnd = reinterpret_cast<HWND>(quintptr(++m_nextWindow * 4));
+    FAKEWINDOW window = {};
+    window.geometry = geometry;
+    window.style = style;
+    window.parent = parent;
+    m_windows.insert(hWnd, window);
+    return hWnd;
+}
+
+void FakeWin32Backend::destroyWindow(const HWND hWnd) {
+    m_windows.remove(hWnd);
+}
+
+FakeWin32Backend::FAKEWINDOW *FakeWin32Backend::window(const HWND hWnd) {
+    const auto it = m_windows.find(hWnd);
+    return (it != m_windows.end()) ? &(*it) : nullptr;
+}
+
+void FakeWin32Backend::setTaskbar(const UINT edge, const bool autoHide) {
+    m_taskbarEdge = edge;
+    m_taskbarAutoHide = autoHide;
+    FAKEMONITOR &primary = m_monitors.first();
+    primary.workArea = primary.geometry;
+    if (!autoHide) {
+        const QRect taskbar = getTaskbarGeometry();
+        switch (edge) {
+        case ABE_LEFT:
+            primary.workArea.setLeft(taskbar.right() + 1);
+            break;
+        case ABE_TOP:
+            primary.workArea.setTop(taskbar.bottom() + 1);
+            break;
+        case ABE_RIGHT:
+            primary.workArea.setRight(taskbar.left() - 1);
+            break;
+        default:
+            primary.workArea.setBottom(taskbar.top() - 1);
+            break;
+        }
+    }
+    m_windows[m_taskbar].geometry = getTaskbarGeometry();
+}
+
+int FakeWin32Backend::callCount(const char *function) const {
+    for (auto it = m_calls.constBegin(); it != m_calls.constEnd(); ++it) {
+        if (qstrcmp(it.key(), function) == 0) {
+            return it.value();
+        }
+    }
+    return 0;
+}
+
+int FakeWin32Backend::totalCallCount() const {
+    int total = 0;
+    for (auto &&count : qAsConst(m_calls)) {
+        total += count;
+    }
+    return total;
+}
+
+QHash<QByteArray, int> FakeWin32Backend::callCounts() const {
+    QHash<QByteArray, int> counts = {};
+    for (auto it = m_calls.constBegin(); it != m_calls.constEnd(); ++it) {
+        counts.insert(QByteArray(it.key()), it.value());
+    }
+    return counts;
+}
+
+void FakeWin32Backend::resetCallCounts() { m_calls.clear(); }
+
+void FakeWin32Backend::countCall(const char *function) { ++m_calls[function]; }
+
+int FakeWin32Backend::getMonitorIndex(const HWND hWnd,
+                                      const DWORD flags) const {
+    const auto it = m_windows.constFind(hWnd);
+    if (it == m_windows.constEnd()) {
+        return (flags == MONITOR_DEFAULTTONULL) ? -1 : 0;
+    }
+    const QRect geometry = it->geometry;
+    int index = -1, largestArea = 0;
+    for (int i = 0; i != m_monitors.size(); ++i) {
+        const QRect overlap = m_monitors.at(i).geometry.intersected(geometry);
+        const int area = overlap.width() * overlap.height();
+        if (area > largestArea) {
+            index = i;
+            largestArea = area;
+        }
+    }
+    if ((index >= 0) || (flags == MONITOR_DEFAULTTONULL)) {
+        return index;
+    }
+    if (flags == MONITOR_DEFAULTTOPRIMARY) {
+        return 0;
+    }
+    // MONITOR_DEFAULTTONEAREST
+    const QPoint center = geometry.center();
+    int distance = -1;
+    for (int i = 0; i != m_monitors.size(); ++i) {
+        const QRect monitor = m_monitors.at(i).geometry;
+        const int dx = qMax(0, qMax(monitor.left() - center.x(),
+                                    center.x() - monitor.right()));
+        const int dy = qMax(0, qMax(monitor.top() - center.y(),
+                                    center.y() - monitor.bottom()));
+        if ((distance < 0) || ((dx + dy) < distance)) {
+            index = i;
+            distance = dx + dy;
+        }
+    }
+    return index;
+}
+
+QRect FakeWin32Backend::getTaskbarGeometry() const {
+    const QRect primary = m_monitors.first().geometry;
+    const int thickness = m_taskbarAutoHide
+        ? 2
+        : scaleForDpi(m_taskbarThickness, m_monitors.first().dotsPerInch);
+    switch (m_taskbarEdge) {
+    case ABE_LEFT:
+        return {primary.left(), primary.top(), thickness, primary.height()};
+    case ABE_TOP:
+        return {primary.left(), primary.top(), primary.width(), thickness};
+    case ABE_RIGHT:
+        return {primary.right() - thickness + 1, primary.top(), thickness,
+                primary.height()};
+    default:
+        return {primary.left(), primary.bottom() - thickness + 1,
+                primary.width(), thickness};
+    }
+}
+
+BOOL FakeWin32Backend::IsWindow(HWND hWnd) {
+    countCall(__func__);
+    return m_windows.contains(hWnd);
+}
+
+BOOL FakeWin32Backend::GetWindowInfo(HWND hwnd, LPWINDOWINFO pwi) {
+    countCall(__func__);
+    const auto it = m_windows.constFind(hwnd);
+    if ((it == m_windows.constEnd()) || !pwi) {
+        return FALSE;
+    }
+    // The client area of a frameless window covers all of it.
+    pwi->rcWindow = toRECT(it->geometry);
+    pwi->rcClient = pwi->rcWindow;
+    pwi->dwStyle = static_cast<DWORD>(it->style);
+    pwi->dwExStyle = static_cast<DWORD>(it->exStyle);
+    return TRUE;
+}
+
+LONG_PTR FakeWin32Backend::GetWindowLongPtrW(HWND hWnd, int nIndex) {
+    countCall(__func__);
+    const auto it = m_windows.constFind(hWnd);
+    if (it == m_windows.constEnd()) {
+        return 0;
+    }
+    switch (nIndex) {
+    case GWL_STYLE:
+        return it->style;
+    case GWL_EXSTYLE:
+        return it->exStyle;
+    case GWLP_USERDATA:
+        return it->userData;
+    default:
+        return 0;
+    }
+}
+
+LONG_PTR FakeWin32Backend::SetWindowLongPtrW(HWND hWnd, int nIndex,
+                                             LONG_PTR dwNewLong) {
+    countCall(__func__);
+    const auto it = m_windows.find(hWnd);
+    if (it == m_windows.end()) {
+        return 0;
+    }
+    LONG_PTR *value = nullptr;
+    switch (nIndex) {
+    case GWL_STYLE:
+        value = &it->style;
+        break;
+    case GWL_EXSTYLE:
+        value = &it->exStyle;
+        break;
+    case GWLP_USERDATA:
+        value = &it->userData;
+        break;
+    default:
+        return 0;
+    }
+    const LONG_PTR previous = *value;
+    *value = dwNewLong;
+    return previous;
+}
+
+HWND FakeWin32Backend::GetAncestor(HWND hwnd, UINT gaFlags) {
+    countCall(__func__);
+    const auto it = m_windows.constFind(hwnd);
+    if ((it == m_windows.constEnd()) || (gaFlags != GA_PARENT) ||
+        (hwnd == m_desktop)) {
+        return nullptr;
+    }
+    return it->parent ? it->parent : m_desktop;
+}
+
+HWND FakeWin32Backend::GetDesktopWindow() {
+    countCall(__func__);
+    return m_desktop;
+}
+
+HWND FakeWin32Backend::FindWindowW(LPCWSTR lpClassName,
+                                   LPCWSTR lpWindowName) {
+    countCall(__func__);
+    Q_UNUSED(lpWindowName)
+    return (lpClassName && (std::wcscmp(lpClassName, L"Shell_TrayWnd") == 0))
+        ? m_taskbar
+        : nullptr;
+}
+
+BOOL FakeWin32Backend::IsZoomed(HWND hWnd) {
+    countCall(__func__);
+    const auto it = m_windows.constFind(hWnd);
+    return (it != m_windows.constEnd()) && (it->style & WS_MAXIMIZE);
+}
+
+BOOL FakeWin32Backend::GetClientRect(HWND hWnd, LPRECT lpRect) {
+    countCall(__func__);
+    const auto it = m_windows.constFind(hWnd);
+    if ((it == m_windows.constEnd()) || !lpRect) {
+        return FALSE;
+    }
+    *lpRect = {0, 0, it->geometry.width(), it->geometry.height()};
+    return TRUE;
+}
+
+BOOL FakeWin32Backend::ScreenToClient(HWND hWnd, LPPOINT lpPoint) {
+    countCall(__func__);
+    const auto it = m_windows.constFind(hWnd);
+    if ((it == m_windows.constEnd()) || !lpPoint) {
+        return FALSE;
+    }
+    lpPoint->x -= it->geometry.x();
+    lpPoint->y -= it->geometry.y();
+    return TRUE;
+}
+
+BOOL FakeWin32Backend::EqualRect(CONST RECT *lprc1, CONST RECT *lprc2) {
+    countCall(__func__);
+    return lprc1 && lprc2 && (lprc1->left == lprc2->left) &&
+        (lprc1->top == lprc2->top) && (lprc1->right == lprc2->right) &&
+        (lprc1->bottom == lprc2->bottom);
+}
+
+BOOL FakeWin32Backend::SetWindowPos(HWND hWnd, HWND hWndInsertAfter, int X,
+                                    int Y, int cx, int cy, UINT uFlags) {
+    countCall(__func__);
+    Q_UNUSED(hWndInsertAfter)
+    const auto it = m_windows.find(hWnd);
+    if (it == m_windows.end()) {
+        return FALSE;
+    }
+    if (!(uFlags & SWP_NOMOVE)) {
+        it->geometry.moveTo(X, Y);
+    }
+    if (!(uFlags & SWP_NOSIZE)) {
+        it->geometry.setSize({cx, cy});
+    }
+    return TRUE;
+}
+
+BOOL FakeWin32Backend::MoveWindow(HWND hWnd, int X, int Y, int nWidth,
+                                  int nHeight, BOOL bRepaint) {
+    countCall(__func__);
+    Q_UNUSED(bRepaint)
+    const auto it = m_windows.find(hWnd);
+    if (it == m_windows.end()) {
+        return FALSE;
+    }
+    it->geometry = {X, Y, nWidth, nHeight};
+    return TRUE;
+}
+
+BOOL FakeWin32Backend::RedrawWindow(HWND hWnd, CONST RECT *lprcUpdate,
+                                    HRGN hrgnUpdate, UINT flags) {
+    countCall(__func__);
+    Q_UNUSED(lprcUpdate)
+    Q_UNUSED(hrgnUpdate)
+    Q_UNUSED(flags)
+    return m_windows.contains(hWnd);
+}
+
+LRESULT FakeWin32Backend::DefWindowProcW(HWND hWnd, UINT Msg, WPARAM wParam,
+                                         LPARAM lParam) {
+    countCall(__func__);
+    Q_UNUSED(hWnd)
+    Q_UNUSED(wParam)
+    Q_UNUSED(lParam)
+    switch (Msg) {
+    case WM_NCCREATE:
+    case WM_NCACTIVATE:
+        return TRUE;
+    default:
+        return 0;
+    }
+}
+
+BOOL FakeWin32Backend::SetLayeredWindowAttributes(HWND hwnd, COLORREF crKey,
+                                                  BYTE bAlpha,
+                                                  DWORD dwFlags) {
+    countCall(__func__);
+    Q_UNUSED(crKey)
+    Q_UNUSED(bAlpha)
+    Q_UNUSED(dwFlags)
+    const auto it = m_windows.constFind(hwnd);
+    return (it != m_windows.constEnd()) && (it->exStyle & WS_EX_LAYERED);
+}
+
+HMONITOR FakeWin32Backend::MonitorFromWindow(HWND hwnd, DWORD dwFlags) {
+    countCall(__func__);
+    return toHMONITOR(getMonitorIndex(hwnd, dwFlags));
+}
+
+BOOL FakeWin32Backend::GetMonitorInfoW(HMONITOR hMonitor,
+                                       LPMONITORINFO lpmi) {
+    countCall(__func__);
+    const int index = toMonitorIndex(hMonitor);
+    if ((index < 0) || (index >= m_monitors.size()) || !lpmi) {
+        return FALSE;
+    }
+    lpmi->rcMonitor = toRECT(m_monitors.at(index).geometry);
+    lpmi->rcWork = toRECT(m_monitors.at(index).workArea);
+    lpmi->dwFlags = (index == 0) ? MONITORINFOF_PRIMARY : 0;
+    return TRUE;
+}
+
+HDC FakeWin32Backend::GetDC(HWND hWnd) {
+    countCall(__func__);
+    // Only the DC of the screen, the filter doesn't ask for others.
+    return hWnd ? nullptr : m_screenDC;
+}
+
+int FakeWin32Backend::ReleaseDC(HWND hWnd, HDC hDC) {
+    countCall(__func__);
+    Q_UNUSED(hWnd)
+    return (hDC == m_screenDC) ? 1 : 0;
+}
+
+int FakeWin32Backend::GetSystemMetrics(int nIndex) {
+    countCall(__func__);
+    // Scaled to the DPI of the system, the process is DPI aware.
+    return getSystemMetricForDpi(nIndex, m_monitors.first().dotsPerInch);
+}
+
+BOOL FakeWin32Backend::AdjustWindowRectEx(LPRECT lpRect, DWORD dwStyle,
+                                          BOOL bMenu, DWORD dwExStyle) {
+    countCall(__func__);
+    Q_UNUSED(bMenu)
+    Q_UNUSED(dwExStyle)
+    return adjustWindowRectForDpi(lpRect, dwStyle,
+                                  m_monitors.first().dotsPerInch);
+}
+
+BOOL FakeWin32Backend::IsProcessDPIAware() {
+    countCall(__func__);
+    return TRUE;
+}
+
+UINT FakeWin32Backend::GetDpiForWindow(HWND hwnd) {
+    countCall(__func__);
+    if (!m_windows.contains(hwnd)) {
+        return 0;
+    }
+    return m_monitors.at(getMonitorIndex(hwnd, MONITOR_DEFAULTTONEAREST))
+        .dotsPerInch;
+}
+
+UINT FakeWin32Backend::GetDpiForSystem() {
+    countCall(__func__);
+    return m_monitors.first().dotsPerInch;
+}
+
+int FakeWin32Backend::GetSystemMetricsForDpi(int nIndex, UINT dpi) {
+    countCall(__func__);
+    return getSystemMetricForDpi(nIndex, dpi);
+}
+
+BOOL FakeWin32Backend::AdjustWindowRectExForDpi(LPRECT lpRect, DWORD dwStyle,
+                                                BOOL bMenu, DWORD dwExStyle,
+                                                UINT dpi) {
+    countCall(__func__);
+    Q_UNUSED(bMenu)
+    Q_UNUSED(dwExStyle)
+    return adjustWindowRectForDpi(lpRect, dwStyle, dpi);
+}
+
+UINT FakeWin32Backend::GetSystemDpiForProcess(HANDLE hProcess) {
+    countCall(__func__);
+    return (hProcess == m_currentProcess) ? m_monitors.first().dotsPerInch
+                                          : 0;
+}
+
+int FakeWin32Backend::GetDeviceCaps(HDC hdc, int index) {
+    countCall(__func__);
+    if ((hdc != m_screenDC) ||
+        ((index != LOGPIXELSX) && (index != LOGPIXELSY))) {
+        return 0;
+    }
+    return static_cast<int>(m_monitors.first().dotsPerInch);
+}
+
+UINT_PTR FakeWin32Backend::SHAppBarMessage(DWORD dwMessage,
+                                           APPBARDATA *pData) {
+    countCall(__func__);
+    if (!pData) {
+        return 0;
+    }
+    switch (dwMessage) {
+    case ABM_GETSTATE:
+        return m_taskbarAutoHide ? (ABS_AUTOHIDE | ABS_ALWAYSONTOP)
+                                 : ABS_ALWAYSONTOP;
+    case ABM_GETTASKBARPOS:
+        pData->hWnd = m_taskbar;
+        pData->uEdge = m_taskbarEdge;
+        pData->rc = toRECT(getTaskbarGeometry());
+        return TRUE;
+    case ABM_GETAUTOHIDEBAREX: {
+        const RECT primary = toRECT(m_monitors.first().geometry);
+        const bool onPrimary = (pData->rc.left == primary.left) &&
+            (pData->rc.top == primary.top) &&
+            (pData->rc.right == primary.right) &&
+            (pData->rc.bottom == primary.bottom);
+        return (m_taskbarAutoHide && onPrimary &&
+                (pData->uEdge == m_taskbarEdge))
+            ? reinterpret_cast<UINT_PTR>(m_taskbar)
+            : 0;
+    }
+    default:
+        return 0;
+    }
+}
+
+HANDLE FakeWin32Backend::GetCurrentProcess() {
+    countCall(__func__);
+    return m_currentProcess;
+}
+
+HRESULT FakeWin32Backend::DwmIsCompositionEnabled(BOOL *pfEnabled) {
+    countCall(__func__);
+    if (!pfEnabled) {
+        return E_FAIL;
+    }
+    // Always, since Windows 8.
+    *pfEnabled = TRUE;
+    return S_OK;
+}
+
+HRESULT
+FakeWin32Backend::DwmExtendFrameIntoClientArea(HWND hWnd,
+                                               CONST MARGINS *pMarInset) {
+    countCall(__func__);
+    const auto it = m_windows.find(hWnd);
+    if ((it == m_windows.end()) || !pMarInset) {
+        return E_FAIL;
+    }
+    it->frameMargins = *pMarInset;
+    return S_OK;
+}
+
+HRESULT FakeWin32Backend::DwmSetWindowAttribute(HWND hwnd, DWORD dwAttribute,
+                                                LPCVOID pvAttribute,
+                                                DWORD cbAttribute) {
+    countCall(__func__);
+    Q_UNUSED(dwAttribute)
+    Q_UNUSED(cbAttribute)
+    return (m_windows.contains(hwnd) && pvAttribute) ? S_OK : E_FAIL;
+}
+
+HRESULT FakeWin32Backend::GetDpiForMonitor(HMONITOR hmonitor,
+                                           MONITOR_DPI_TYPE dpiType,
+                                           UINT *dpiX, UINT *dpiY) {
+    countCall(__func__);
+    Q_UNUSED(dpiType)
+    const int index = toMonitorIndex(hmonitor);
+    if ((index < 0) || (index >= m_monitors.size()) || !dpiX || !dpiY) {
+        return E_FAIL;
+    }
+    *dpiX = m_monitors.at(index).dotsPerInch;
+    *dpiY = *dpiX;
+    return S_OK;
+}
+
+HRESULT
+FakeWin32Backend::GetProcessDpiAwareness(HANDLE hprocess,
+                                         PROCESS_DPI_AWARENESS *value) {
+    countCall(__func__);
+    if ((hprocess != m_currentProcess) || !value) {
+        return E_FAIL;
+    }
+    *value = PROCESS_PER_MONITOR_DPI_AWARE;
+    return S_OK;
+}
+
+LONG FakeWin32Backend::RtlGetVersion(PRTL_OSVERSIONINFOW lpVersionInformation) {
+    countCall(__func__);
+    if (!lpVersionInformation) {
+        // STATUS_INVALID_PARAMETER
+        return static_cast<LONG>(0xC000000DL);
+    }
+    lpVersionInformation->dwMajorVersion = m_majorVersion;
+    lpVersionInformation->dwMinorVersion = m_minorVersion;
+    lpVersionInformation->dwBuildNumber = m_buildNumber;
+    lpVersionInformation->dwPlatformId = VER_PLATFORM_WIN32_NT;
+    lpVersionInformation->szCSDVersion[0] = L'\0';
+    // STATUS_SUCCESS
+    return 0;
+}
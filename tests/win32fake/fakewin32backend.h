@@ -0,0 +1,152 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "win32backend.h"
+#include <QByteArray>
+#include <QHash>
+#include <QRect>
+#include <QVector>
+
+// A fake of the Win32 API WinNativeEventFilter calls, in memory: windows with
+// their geometry, styles and GWLP_USERDATA, monitors with their work areas
+// and DPIs, the taskbar, and a counter per function. Geometries are in
+// physical pixels, like the ones of Win32. A window belongs to the monitor
+// it overlaps most and has that monitor's DPI. There are no window
+// procedures, MoveWindow() and SetWindowPos() change the geometry without
+// sending any messages, feed them to the filter yourself.
+class FakeWin32Backend : public Win32Backend {
+    Q_DISABLE_COPY_MOVE(FakeWin32Backend)
+
+public:
+    using FAKEMONITOR = struct _FAKEMONITOR {
+        QRect geometry = {}, workArea = {};
+        UINT dotsPerInch = 96;
+    };
+
+    using FAKEWINDOW = struct _FAKEWINDOW {
+        QRect geometry = {};
+        LONG_PTR style = 0, exStyle = 0, userData = 0;
+        HWND parent = nullptr;
+        MARGINS frameMargins = {0, 0, 0, 0};
+    };
+
+    explicit FakeWin32Backend();
+    ~FakeWin32Backend() override = default;
+
+    // Back to Windows 10 2004 (10.0.19041), one 1920x1080 monitor at 96 DPI
+    // with the taskbar at the bottom, no windows and no calls counted.
+    void reset();
+
+    // The version RtlGetVersion() returns, set it before the filter resolves
+    // the Win32 functions to leave out the ones of newer versions.
+    void setVersion(const DWORD major, const DWORD minor, const DWORD build);
+
+    // The first monitor is the primary one.
+    int addMonitor(const QRect &geometry, const QRect &workArea,
+                   const UINT dotsPerInch = 96);
+    FAKEMONITOR *monitor(const int index);
+
+    HWND createWindow(const QRect &geometry,
+                      const LONG_PTR style = WS_OVERLAPPEDWINDOW | WS_VISIBLE,
+                      const HWND parent = nullptr);
+    void destroyWindow(const HWND hWnd);
+    FAKEWINDOW *window(const HWND hWnd);
+
+    // The taskbar is on the primary monitor, edge is one of the ABE_*.
+    void setTaskbar(const UINT edge, const bool autoHide);
+
+    int callCount(const char *function) const;
+    int totalCallCount() const;
+    QHash<QByteArray, int> callCounts() const;
+    void resetCallCounts();
+
+    BOOL IsWindow(HWND hWnd) override;
+    BOOL GetWindowInfo(HWND hwnd, LPWINDOWINFO pwi) override;
+    LONG_PTR GetWindowLongPtrW(HWND hWnd, int nIndex) override;
+    LONG_PTR SetWindowLongPtrW(HWND hWnd, int nIndex,
+                               LONG_PTR dwNewLong) override;
+    HWND GetAncestor(HWND hwnd, UINT gaFlags) override;
+    HWND GetDesktopWindow() override;
+    HWND FindWindowW(LPCWSTR lpClassName, LPCWSTR lpWindowName) override;
+    BOOL IsZoomed(HWND hWnd) override;
+    BOOL GetClientRect(HWND hWnd, LPRECT lpRect) override;
+    BOOL ScreenToClient(HWND hWnd, LPPOINT lpPoint) override;
+    BOOL EqualRect(CONST RECT *lprc1, CONST RECT *lprc2) override;
+    BOOL SetWindowPos(HWND hWnd, HWND hWndInsertAfter, int X, int Y, int cx,
+                      int cy, UINT uFlags) override;
+    BOOL MoveWindow(HWND hWnd, int X, int Y, int nWidth, int nHeight,
+                    BOOL bRepaint) override;
+    BOOL RedrawWindow(HWND hWnd, CONST RECT *lprcUpdate, HRGN hrgnUpdate,
+                      UINT flags) override;
+    LRESULT DefWindowProcW(HWND hWnd, UINT Msg, WPARAM wParam,
+                           LPARAM lParam) override;
+    BOOL SetLayeredWindowAttributes(HWND hwnd, COLORREF crKey, BYTE bAlpha,
+                                    DWORD dwFlags) override;
+    HMONITOR MonitorFromWindow(HWND hwnd, DWORD dwFlags) override;
+    BOOL GetMonitorInfoW(HMONITOR hMonitor, LPMONITORINFO lpmi) override;
+    HDC GetDC(HWND hWnd) override;
+    int ReleaseDC(HWND hWnd, HDC hDC) override;
+    int GetSystemMetrics(int nIndex) override;
+    BOOL AdjustWindowRectEx(LPRECT lpRect, DWORD dwStyle, BOOL bMenu,
+                            DWORD dwExStyle) override;
+    BOOL IsProcessDPIAware() override;
+    UINT GetDpiForWindow(HWND hwnd) override;
+    UINT GetDpiForSystem() override;
+    int GetSystemMetricsForDpi(int nIndex, UINT dpi) override;
+    BOOL AdjustWindowRectExForDpi(LPRECT lpRect, DWORD dwStyle, BOOL bMenu,
+                                  DWORD dwExStyle, UINT dpi) override;
+    UINT GetSystemDpiForProcess(HANDLE hProcess) override;
+    int GetDeviceCaps(HDC hdc, int index) override;
+    UINT_PTR SHAppBarMessage(DWORD dwMessage, APPBARDATA *pData) override;
+    HANDLE GetCurrentProcess() override;
+    HRESULT DwmIsCompositionEnabled(BOOL *pfEnabled) override;
+    HRESULT DwmExtendFrameIntoClientArea(HWND hWnd,
+                                         CONST MARGINS *pMarInset) override;
+    HRESULT DwmSetWindowAttribute(HWND hwnd, DWORD dwAttribute,
+                                  LPCVOID pvAttribute,
+                                  DWORD cbAttribute) override;
+    HRESULT GetDpiForMonitor(HMONITOR hmonitor, MONITOR_DPI_TYPE dpiType,
+                             UINT *dpiX, UINT *dpiY) override;
+    HRESULT GetProcessDpiAwareness(HANDLE hprocess,
+                                   PROCESS_DPI_AWARENESS *value) override;
+    LONG RtlGetVersion(PRTL_OSVERSIONINFOW lpVersionInformation) override;
+
+private:
+    void countCall(const char *function);
+    int getMonitorIndex(const HWND hWnd, const DWORD flags) const;
+    QRect getTaskbarGeometry() const;
+
+    QVector<FAKEMONITOR> m_monitors = {};
+    QHash<HWND, FAKEWINDOW> m_windows = {};
+    quintptr m_nextWindow = 0;
+    HWND m_desktop = nullptr, m_taskbar = nullptr;
+    UINT m_taskbarEdge = 0;
+    bool m_taskbarAutoHide = false;
+    DWORD m_majorVersion = 0, m_minorVersion = 0, m_buildNumber = 0;
+    // The key is __func__ of the function, unique per function.
+    QHash<const char *, int> m_calls = {};
+};
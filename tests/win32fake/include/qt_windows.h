@@ -0,0 +1,278 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// Stands in for Qt's qt_windows.h (and windows.h) when WinNativeEventFilter is
+// built on another platform against FakeWin32Backend. Only the types, macros
+// and constants the filter and the fake use are declared, with the values of
+// the Windows 10 SDK. There are no functions, the filter gets all of them
+// through SymbolResolver. 64 bit only, like the hosts we build the fake on.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#define WINAPI
+#define CONST const
+#define TRUE 1
+#define FALSE 0
+
+using BOOL = int;
+using BYTE = unsigned char;
+using WORD = std::uint16_t;
+using DWORD = std::uint32_t;
+using UINT = unsigned int;
+using LONG = std::int32_t;
+using LONG_PTR = std::intptr_t;
+using ULONG_PTR = std::uintptr_t;
+using UINT_PTR = std::uintptr_t;
+using WPARAM = UINT_PTR;
+using LPARAM = LONG_PTR;
+using LRESULT = LONG_PTR;
+using HRESULT = LONG;
+using COLORREF = DWORD;
+using ATOM = WORD;
+using WCHAR = wchar_t;
+using LPCWSTR = const WCHAR *;
+using PVOID = void *;
+using LPVOID = void *;
+using LPCVOID = const void *;
+
+using HANDLE = void *;
+using HGDIOBJ = void *;
+struct HWND__;
+using HWND = HWND__ *;
+struct HMONITOR__;
+using HMONITOR = HMONITOR__ *;
+struct HDC__;
+using HDC = HDC__ *;
+struct HRGN__;
+using HRGN = HRGN__ *;
+struct HBRUSH__;
+using HBRUSH = HBRUSH__ *;
+struct HINSTANCE__;
+using HINSTANCE = HINSTANCE__ *;
+struct HMENU__;
+using HMENU = HMENU__ *;
+
+using RECT = struct tagRECT {
+    LONG left;
+    LONG top;
+    LONG right;
+    LONG bottom;
+};
+using LPRECT = RECT *;
+
+using POINT = struct tagPOINT {
+    LONG x;
+    LONG y;
+};
+using LPPOINT = POINT *;
+
+using MSG = struct tagMSG {
+    HWND hwnd;
+    UINT message;
+    WPARAM wParam;
+    LPARAM lParam;
+    DWORD time;
+    POINT pt;
+};
+using LPMSG = MSG *;
+
+using WINDOWINFO = struct tagWINDOWINFO {
+    DWORD cbSize;
+    RECT rcWindow;
+    RECT rcClient;
+    DWORD dwStyle;
+    DWORD dwExStyle;
+    DWORD dwWindowStatus;
+    UINT cxWindowBorders;
+    UINT cyWindowBorders;
+    ATOM atomWindowType;
+    WORD wCreatorVersion;
+};
+using LPWINDOWINFO = WINDOWINFO *;
+
+using MONITORINFO = struct tagMONITORINFO {
+    DWORD cbSize;
+    RECT rcMonitor;
+    RECT rcWork;
+    DWORD dwFlags;
+};
+using LPMONITORINFO = MONITORINFO *;
+
+using PAINTSTRUCT = struct tagPAINTSTRUCT {
+    HDC hdc;
+    BOOL fErase;
+    RECT rcPaint;
+    BOOL fRestore;
+    BOOL fIncUpdate;
+    BYTE rgbReserved[32];
+};
+using LPPAINTSTRUCT = PAINTSTRUCT *;
+
+using CREATESTRUCTW = struct tagCREATESTRUCTW {
+    LPVOID lpCreateParams;
+    HINSTANCE hInstance;
+    HMENU hMenu;
+    HWND hwndParent;
+    int cy;
+    int cx;
+    int y;
+    int x;
+    LONG style;
+    LPCWSTR lpszName;
+    LPCWSTR lpszClass;
+    DWORD dwExStyle;
+};
+using LPCREATESTRUCTW = CREATESTRUCTW *;
+
+using WINDOWPOS = struct tagWINDOWPOS {
+    HWND hwnd;
+    HWND hwndInsertAfter;
+    int x;
+    int y;
+    int cx;
+    int cy;
+    UINT flags;
+};
+
+using NCCALCSIZE_PARAMS = struct tagNCCALCSIZE_PARAMS {
+    RECT rgrc[3];
+    WINDOWPOS *lppos;
+};
+using LPNCCALCSIZE_PARAMS = NCCALCSIZE_PARAMS *;
+
+using MINMAXINFO = struct tagMINMAXINFO {
+    POINT ptReserved;
+    POINT ptMaxSize;
+    POINT ptMaxPosition;
+    POINT ptMinTrackSize;
+    POINT ptMaxTrackSize;
+};
+using LPMINMAXINFO = MINMAXINFO *;
+
+using RTL_OSVERSIONINFOW = struct _OSVERSIONINFOW {
+    DWORD dwOSVersionInfoSize;
+    DWORD dwMajorVersion;
+    DWORD dwMinorVersion;
+    DWORD dwBuildNumber;
+    DWORD dwPlatformId;
+    WCHAR szCSDVersion[128];
+};
+using PRTL_OSVERSIONINFOW = RTL_OSVERSIONINFOW *;
+
+inline void *SecureZeroMemory(void *ptr, const std::size_t cnt) {
+    return std::memset(ptr, 0, cnt);
+}
+
+#define S_OK ((HRESULT)0L)
+#define E_FAIL ((HRESULT)0x80004005L)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+
+#define LOWORD(l) ((WORD)(((DWORD)(l)) & 0xffff))
+#define HIWORD(l) ((WORD)((((DWORD)(l)) >> 16) & 0xffff))
+#define MAKELONG(a, b) ((LONG)(((WORD)(a)) | ((DWORD)((WORD)(b))) << 16))
+#define MAKELPARAM(l, h) ((LPARAM)(DWORD)MAKELONG(l, h))
+#define MAKEWPARAM(l, h) ((WPARAM)(DWORD)MAKELONG(l, h))
+#define RGB(r, g, b)                                                           \
+    ((COLORREF)(((BYTE)(r) | ((WORD)((BYTE)(g)) << 8)) |                       \
+                (((DWORD)(BYTE)(b)) << 16)))
+
+#define GWL_STYLE (-16)
+#define GWL_EXSTYLE (-20)
+#define GWLP_USERDATA (-21)
+
+#define WS_OVERLAPPED 0x00000000L
+#define WS_POPUP 0x80000000L
+#define WS_CHILD 0x40000000L
+#define WS_MINIMIZE 0x20000000L
+#define WS_VISIBLE 0x10000000L
+#define WS_CLIPSIBLINGS 0x04000000L
+#define WS_CLIPCHILDREN 0x02000000L
+#define WS_MAXIMIZE 0x01000000L
+#define WS_CAPTION 0x00C00000L
+#define WS_SYSMENU 0x00080000L
+#define WS_THICKFRAME 0x00040000L
+#define WS_MINIMIZEBOX 0x00020000L
+#define WS_MAXIMIZEBOX 0x00010000L
+#define WS_OVERLAPPEDWINDOW                                                    \
+    (WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU | WS_THICKFRAME |                 \
+     WS_MINIMIZEBOX | WS_MAXIMIZEBOX)
+#define WS_EX_LAYERED 0x00080000L
+
+#define GA_PARENT 1
+#define MONITOR_DEFAULTTONULL 0x00000000
+#define MONITOR_DEFAULTTOPRIMARY 0x00000001
+#define MONITOR_DEFAULTTONEAREST 0x00000002
+#define MONITORINFOF_PRIMARY 0x00000001
+
+#define LOGPIXELSX 88
+#define LOGPIXELSY 90
+
+#define VER_PLATFORM_WIN32_NT 2
+
+#define SM_CYCAPTION 4
+#define SM_CXSIZEFRAME 32
+#define SM_CYSIZEFRAME 33
+
+#define LWA_COLORKEY 0x00000001
+
+#define SWP_NOSIZE 0x0001
+#define SWP_NOMOVE 0x0002
+#define SWP_NOZORDER 0x0004
+#define SWP_NOACTIVATE 0x0010
+#define SWP_FRAMECHANGED 0x0020
+#define SWP_NOOWNERZORDER 0x0200
+
+#define RDW_INVALIDATE 0x0001
+#define RDW_NOCHILDREN 0x0040
+#define RDW_UPDATENOW 0x0100
+
+#define WM_SIZE 0x0005
+#define WM_SETTEXT 0x000C
+#define WM_GETMINMAXINFO 0x0024
+#define WM_SETICON 0x0080
+#define WM_NCCREATE 0x0081
+#define WM_NCCALCSIZE 0x0083
+#define WM_NCHITTEST 0x0084
+#define WM_NCPAINT 0x0085
+#define WM_NCACTIVATE 0x0086
+#define WM_MOUSEMOVE 0x0200
+
+#define WVR_REDRAW 0x0300
+
+#define HTTRANSPARENT (-1)
+#define HTCLIENT 1
+#define HTCAPTION 2
+#define HTLEFT 10
+#define HTRIGHT 11
+#define HTTOP 12
+#define HTTOPLEFT 13
+#define HTTOPRIGHT 14
+#define HTBOTTOM 15
+#define HTBOTTOMLEFT 16
+#define HTBOTTOMRIGHT 17
+#define HTBORDER 18
@@ -0,0 +1,56 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "winnativeeventfilter.h"
+#include <QPoint>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+using NativeEventResult = qintptr;
+#else
+using NativeEventResult = long;
+#endif
+
+// Hands a message to the filter the way Qt's event dispatcher does, as if
+// the window procedure of hWnd had received it.
+inline bool sendSyntheticMessage(WinNativeEventFilter &filter, const HWND hWnd,
+                                 const UINT message, const WPARAM wParam,
+                                 const LPARAM lParam,
+                                 NativeEventResult *result) {
+    MSG msg;
+    SecureZeroMemory(&msg, sizeof(msg));
+    msg.hwnd = hWnd;
+    msg.message = message;
+    msg.wParam = wParam;
+    msg.lParam = lParam;
+    return filter.nativeEventFilter(QByteArrayLiteral("windows_generic_MSG"),
+                                    &msg, result);
+}
+
+// The lParam of WM_NCHITTEST, a position on the screen in physical pixels.
+inline LPARAM makeScreenPosition(const QPoint &pos) {
+    return MAKELPARAM(pos.x(), pos.y());
+}
@@ -0,0 +1,16 @@
+# WinNativeEventFilter on FakeWin32Backend, shared by the tests and the
+# benchmarks of the filter. Builds on every platform, elsewhere than on
+# Windows the Win32 types come from include/qt_windows.h. Only Qt GUI, the
+# Qt Widgets and Qt Quick parts of the filter are left out.
+!win32: INCLUDEPATH += $$PWD/include
+INCLUDEPATH += $$PWD $$PWD/../..
+QT += gui-private testlib
+CONFIG += c++17 strict_c++ utf8_source warn_on console
+CONFIG -= app_bundle
+DEFINES += WIN32_LEAN_AND_MEAN QT_NO_CAST_FROM_ASCII QT_NO_CAST_TO_ASCII
+HEADERS += $$PWD/../../winnativeeventfilter.h $$PWD/../../win32backend.h \
+    $$PWD/../../symbolresolver.h $$PWD/fakewin32backend.h \
+    $$PWD/syntheticmessage.h
+SOURCES += $$PWD/../../winnativeeventfilter.cpp \
+    $$PWD/../../win32backend.cpp $$PWD/../../symbolresolver.cpp \
+    $$PWD/fakewin32backend.cpp
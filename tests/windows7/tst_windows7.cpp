@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// WinNativeEventFilter on a FakeWin32Backend which pretends to be Windows 7.
+// The filter resolves the functions of newer versions of Windows once per
+// process, so this can't be a row of tst_winnativeeventfilter. Only runs
+// elsewhere than on Windows, on Windows the filter asks Qt for the version.
+
+#include "fakewin32backend.h"
+#include "syntheticmessage.h"
+#include "winnativeeventfilter.h"
+#include <QtTest>
+
+#ifndef ABE_TOP
+#define ABE_TOP 1
+#endif
+
+namespace {
+
+// In physical pixels, on the primary monitor.
+const QRect m_windowGeometry = {100, 100, 800, 600};
+
+} // namespace
+
+class Windows7Test : public QObject {
+    Q_OBJECT
+
+public:
+    static void initMain() {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+    void dotsPerInchFromDeviceCaps();
+    void maxPosition_data();
+    void maxPosition();
+
+private:
+    HWND createFramelessWindow();
+    bool getMinMaxInfo(const HWND hWnd, MINMAXINFO *mmi);
+
+    FakeWin32Backend m_backend;
+    QScopedPointer<WinNativeEventFilter> m_filter;
+};
+
+void Windows7Test::initTestCase() {
+    // Windows 7 SP1, before the filter resolves the Win32 functions.
+    m_backend.setVersion(6, 1, 7601);
+    Win32Backend::install(&m_backend);
+    m_filter.reset(new WinNativeEventFilter);
+}
+
+void Windows7Test::cleanupTestCase() {
+    WinNativeEventFilter::clearFramelessWindows();
+    m_filter.reset();
+}
+
+void Windows7Test::init() {
+    m_backend.reset();
+    m_backend.setVersion(6, 1, 7601);
+}
+
+void Windows7Test::cleanup() { WinNativeEventFilter::clearFramelessWindows(); }
+
+HWND Windows7Test::createFramelessWindow() {
+    const HWND hWnd = m_backend.createWindow(m_windowGeometry);
+    WinNativeEventFilter::addFramelessWindow(hWnd);
+    return hWnd;
+}
+
+bool Windows7Test::getMinMaxInfo(const HWND hWnd, MINMAXINFO *mmi) {
+    SecureZeroMemory(mmi, sizeof(MINMAXINFO));
+    NativeEventResult result = -1;
+    return sendSyntheticMessage(*m_filter, hWnd, WM_GETMINMAXINFO, 0,
+                                reinterpret_cast<LPARAM>(mmi), &result) &&
+        (result == 0);
+}
+
+void Windows7Test::dotsPerInchFromDeviceCaps() {
+    m_backend.monitor(0)->dotsPerInch = 192;
+    const HWND hWnd = createFramelessWindow();
+    WinNativeEventFilter::WINDOWDATA data = {};
+    data.minimumSize = {200, 100};
+    WinNativeEventFilter::setWindowData(hWnd, &data);
+    m_backend.resetCallCounts();
+    MINMAXINFO mmi;
+    QVERIFY(getMinMaxInfo(hWnd, &mmi));
+    // Device independent pixels, scaled with the DPI of the screen DC.
+    QCOMPARE(QSize(mmi.ptMinTrackSize.x, mmi.ptMinTrackSize.y),
+             QSize(400, 200));
+    QVERIFY(m_backend.callCount("GetDeviceCaps") > 0);
+    // Not resolved, neither SHCore (8.1) nor the User32 ones of 10.
+    QCOMPARE(m_backend.callCount("GetProcessDpiAwareness"), 0);
+    QCOMPARE(m_backend.callCount("GetDpiForMonitor"), 0);
+    QCOMPARE(m_backend.callCount("GetDpiForWindow"), 0);
+    QCOMPARE(m_backend.callCount("GetSystemDpiForProcess"), 0);
+}
+
+void Windows7Test::maxPosition_data() {
+    QTest::addColumn<DWORD>("majorVersion");
+    QTest::addColumn<DWORD>("minorVersion");
+    QTest::addColumn<DWORD>("buildNumber");
+    QTest::addColumn<QPoint>("maxPosition");
+    // Checked for every message, unlike the resolved functions.
+    QTest::newRow("Windows 7") << DWORD(6) << DWORD(1) << DWORD(7601)
+                               << QPoint{0, 0};
+    // Relative to the monitor.
+    QTest::newRow("Windows 10") << DWORD(10) << DWORD(0) << DWORD(19041)
+                                << QPoint{0, 40};
+}
+
+void Windows7Test::maxPosition() {
+    QFETCH(DWORD, majorVersion);
+    QFETCH(DWORD, minorVersion);
+    QFETCH(DWORD, buildNumber);
+    QFETCH(QPoint, maxPosition);
+    m_backend.setVersion(majorVersion, minorVersion, buildNumber);
+    m_backend.setTaskbar(ABE_TOP, false);
+    const HWND hWnd = createFramelessWindow();
+    MINMAXINFO mmi;
+    QVERIFY(getMinMaxInfo(hWnd, &mmi));
+    QCOMPARE(QPoint(mmi.ptMaxPosition.x, mmi.ptMaxPosition.y), maxPosition);
+    QCOMPARE(QSize(mmi.ptMaxSize.x, mmi.ptMaxSize.y), QSize(1920, 1040));
+}
+
+QTEST_MAIN(Windows7Test)
+
+#include "tst_windows7.moc"
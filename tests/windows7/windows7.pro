@@ -0,0 +1,5 @@
+TARGET = tst_windows7
+TEMPLATE = app
+include(../win32fake/win32fake.pri)
+CONFIG += testcase
+SOURCES += tst_windows7.cpp
@@ -0,0 +1,419 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+// The message handling of WinNativeEventFilter, fed with synthetic messages
+// on FakeWin32Backend. Runs on every platform.
+
+#include "fakewin32backend.h"
+#include "syntheticmessage.h"
+#include "winnativeeventfilter.h"
+#include <QtTest>
+
+#ifndef ABE_TOP
+#define ABE_TOP 1
+#endif
+
+#ifndef ABE_BOTTOM
+#define ABE_BOTTOM 3
+#endif
+
+Q_DECLARE_METATYPE(WinNativeEventFilter::WINDOWDATA)
+
+namespace {
+
+// In physical pixels, on the primary monitor.
+const QRect m_windowGeometry = {100, 100, 800, 600};
+
+QRect fromRECT(const RECT &rect) {
+    return {rect.left, rect.top, rect.right - rect.left,
+            rect.bottom - rect.top};
+}
+
+RECT toRECT(const QRect &rect) {
+    return {rect.left(), rect.top(), rect.left() + rect.width(),
+            rect.top() + rect.height()};
+}
+
+} // namespace
+
+class WinNativeEventFilterTest : public QObject {
+    Q_OBJECT
+
+public:
+    static void initMain() {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+    void initialization_data();
+    void initialization();
+    void userDataFromCreateParams();
+    void onlyTopLevelWindows();
+    void hitTest_data();
+    void hitTest();
+    void calcSize_data();
+    void calcSize();
+    void minMaxInfo_data();
+    void minMaxInfo();
+    void hitTestLeavesWindowAlone();
+
+private:
+    HWND createFramelessWindow(const QRect &geometry = m_windowGeometry);
+    bool send(const HWND hWnd, const UINT message, const WPARAM wParam,
+              const LPARAM lParam, NativeEventResult *result);
+
+    FakeWin32Backend m_backend;
+    QScopedPointer<WinNativeEventFilter> m_filter;
+};
+
+void WinNativeEventFilterTest::initTestCase() {
+    // Before the filter resolves the Win32 functions for the first time.
+    Win32Backend::install(&m_backend);
+    m_filter.reset(new WinNativeEventFilter);
+}
+
+void WinNativeEventFilterTest::cleanupTestCase() {
+    WinNativeEventFilter::clearFramelessWindows();
+    m_filter.reset();
+}
+
+void WinNativeEventFilterTest::init() { m_backend.reset(); }
+
+void WinNativeEventFilterTest::cleanup() {
+    WinNativeEventFilter::clearFramelessWindows();
+}
+
+HWND WinNativeEventFilterTest::createFramelessWindow(const QRect &geometry) {
+    const HWND hWnd = m_backend.createWindow(geometry);
+    WinNativeEventFilter::addFramelessWindow(hWnd);
+    return hWnd;
+}
+
+bool WinNativeEventFilterTest::send(const HWND hWnd, const UINT message,
+                                    const WPARAM wParam, const LPARAM lParam,
+                                    NativeEventResult *result) {
+    return sendSyntheticMessage(*m_filter, hWnd, message, wParam, lParam,
+                                result);
+}
+
+void WinNativeEventFilterTest::initialization_data() {
+    QTest::addColumn<bool>("restoreDefaultWindowStyles");
+    QTest::addColumn<bool>("doNotEnableLayeredWindow");
+    QTest::newRow("default") << false << false;
+    QTest::newRow("restoreDefaultWindowStyles") << true << false;
+    QTest::newRow("doNotEnableLayeredWindow") << false << true;
+}
+
+void WinNativeEventFilterTest::initialization() {
+    QFETCH(bool, restoreDefaultWindowStyles);
+    QFETCH(bool, doNotEnableLayeredWindow);
+    const HWND hWnd = m_backend.createWindow(m_windowGeometry, WS_POPUP);
+    WinNativeEventFilter::WINDOWDATA data = {};
+    data.restoreDefaultWindowStyles = restoreDefaultWindowStyles;
+    data.doNotEnableLayeredWindow = doNotEnableLayeredWindow;
+    WinNativeEventFilter::addFramelessWindow(hWnd, &data);
+    NativeEventResult result = 0;
+    send(hWnd, WM_NCACTIVATE, TRUE, 0, &result);
+    const FakeWin32Backend::FAKEWINDOW *window = m_backend.window(hWnd);
+    QVERIFY(window);
+    QCOMPARE(window->style,
+             restoreDefaultWindowStyles
+                 ? LONG_PTR(WS_OVERLAPPEDWINDOW | WS_CLIPCHILDREN |
+                            WS_CLIPSIBLINGS)
+                 : LONG_PTR(WS_POPUP));
+    QCOMPARE(bool(window->exStyle & WS_EX_LAYERED), !doNotEnableLayeredWindow);
+    // The frame shadow of DWM.
+    QCOMPARE(window->frameMargins.cyTopHeight, 1);
+    // Only once.
+    m_backend.resetCallCounts();
+    send(hWnd, WM_NCACTIVATE, TRUE, 0, &result);
+    QCOMPARE(m_backend.callCount("DwmExtendFrameIntoClientArea"), 0);
+}
+
+void WinNativeEventFilterTest::userDataFromCreateParams() {
+    // Not known to the filter, it handles all the top level windows then.
+    const HWND hWnd = m_backend.createWindow(m_windowGeometry);
+    WinNativeEventFilter::WINDOW window = {};
+    window.hWnd = hWnd;
+    CREATESTRUCTW createStruct;
+    SecureZeroMemory(&createStruct, sizeof(createStruct));
+    createStruct.lpCreateParams = &window;
+    NativeEventResult result = 0;
+    QVERIFY(!send(hWnd, WM_NCCREATE, 0,
+                  reinterpret_cast<LPARAM>(&createStruct), &result));
+    // DefWindowProc's result.
+    QCOMPARE(result, NativeEventResult(TRUE));
+    QCOMPARE(m_backend.window(hWnd)->userData,
+             reinterpret_cast<LONG_PTR>(&window));
+    QVERIFY(WinNativeEventFilter::windowData(hWnd) == &window.windowData);
+}
+
+void WinNativeEventFilterTest::onlyTopLevelWindows() {
+    const HWND parent = m_backend.createWindow(m_windowGeometry);
+    const HWND child = m_backend.createWindow(
+        {10, 10, 100, 100}, WS_CHILD | WS_VISIBLE, parent);
+    NativeEventResult result = 0;
+    QVERIFY(!send(child, WM_NCHITTEST, 0,
+                  makeScreenPosition(m_windowGeometry.topLeft()), &result));
+    QCOMPARE(m_backend.window(child)->userData, LONG_PTR(0));
+    // With a list of frameless windows, only the ones on the list.
+    const HWND frameless = createFramelessWindow();
+    QVERIFY(send(frameless, WM_NCHITTEST, 0,
+                 makeScreenPosition(m_windowGeometry.center()), &result));
+    QVERIFY(!send(parent, WM_NCHITTEST, 0,
+                  makeScreenPosition(m_windowGeometry.center()), &result));
+    QCOMPARE(m_backend.window(parent)->userData, LONG_PTR(0));
+}
+
+void WinNativeEventFilterTest::hitTest_data() {
+    QTest::addColumn<UINT>("dotsPerInch");
+    QTest::addColumn<bool>("maximized");
+    QTest::addColumn<WinNativeEventFilter::WINDOWDATA>("data");
+    QTest::addColumn<QPoint>("pos");
+    QTest::addColumn<int>("expected");
+    // At 96 DPI the borders are 8 pixels wide (twice as wide towards the
+    // corners) and the title bar is 23 pixels high, at 192 DPI twice that.
+    const WinNativeEventFilter::WINDOWDATA none = {};
+    QTest::newRow("client") << 96u << false << none << QPoint{400, 300}
+                            << HTCLIENT;
+    QTest::newRow("top left") << 96u << false << none << QPoint{2, 2}
+                              << HTTOPLEFT;
+    QTest::newRow("top") << 96u << false << none << QPoint{400, 2} << HTTOP;
+    QTest::newRow("top right") << 96u << false << none << QPoint{797, 2}
+                               << HTTOPRIGHT;
+    QTest::newRow("left") << 96u << false << none << QPoint{2, 300}
+                          << HTLEFT;
+    QTest::newRow("right") << 96u << false << none << QPoint{797, 300}
+                           << HTRIGHT;
+    QTest::newRow("bottom") << 96u << false << none << QPoint{400, 597}
+                            << HTBOTTOM;
+    QTest::newRow("bottom left") << 96u << false << none << QPoint{2, 597}
+                                 << HTBOTTOMLEFT;
+    QTest::newRow("bottom right") << 96u << false << none << QPoint{797, 597}
+                                  << HTBOTTOMRIGHT;
+    QTest::newRow("title bar") << 96u << false << none << QPoint{400, 20}
+                               << HTCAPTION;
+    QTest::newRow("below title bar")
+        << 96u << false << none << QPoint{400, 30} << HTCLIENT;
+    QTest::newRow("192 dpi, title bar")
+        << 192u << false << none << QPoint{400, 30} << HTCAPTION;
+    QTest::newRow("192 dpi, top")
+        << 192u << false << none << QPoint{400, 12} << HTTOP;
+    QTest::newRow("192 dpi, left")
+        << 192u << false << none << QPoint{12, 300} << HTLEFT;
+    QTest::newRow("maximized, top")
+        << 96u << true << none << QPoint{400, 2} << HTCAPTION;
+    QTest::newRow("maximized, left")
+        << 96u << true << none << QPoint{2, 300} << HTCLIENT;
+    WinNativeEventFilter::WINDOWDATA data = {};
+    data.fixedSize = TRUE;
+    QTest::newRow("fixed size") << 96u << false << data << QPoint{2, 2}
+                                << HTBORDER;
+    data = {};
+    data.mouseTransparent = TRUE;
+    QTest::newRow("mouse transparent")
+        << 96u << false << data << QPoint{400, 20} << HTTRANSPARENT;
+    data = {};
+    data.disableTitleBar = TRUE;
+    QTest::newRow("title bar disabled")
+        << 96u << false << data << QPoint{400, 20} << HTCLIENT;
+    data = {};
+    data.ignoreAreas = {{300, 0, 200, 30}};
+    QTest::newRow("ignore area")
+        << 96u << false << data << QPoint{400, 20} << HTCLIENT;
+    QTest::newRow("no resizing in ignore area")
+        << 96u << false << data << QPoint{400, 2} << HTCLIENT;
+    QTest::newRow("outside ignore area")
+        << 96u << false << data << QPoint{200, 20} << HTCAPTION;
+    data = {};
+    data.draggableAreas = {{0, 0, 100, 30}};
+    QTest::newRow("draggable area")
+        << 96u << false << data << QPoint{50, 20} << HTCAPTION;
+    QTest::newRow("outside draggable area")
+        << 96u << false << data << QPoint{400, 20} << HTCLIENT;
+    // The areas are in device independent pixels.
+    QTest::newRow("192 dpi, draggable area")
+        << 192u << false << data << QPoint{150, 20} << HTCAPTION;
+}
+
+void WinNativeEventFilterTest::hitTest() {
+    QFETCH(UINT, dotsPerInch);
+    QFETCH(bool, maximized);
+    QFETCH(WinNativeEventFilter::WINDOWDATA, data);
+    QFETCH(QPoint, pos);
+    QFETCH(int, expected);
+    m_backend.monitor(0)->dotsPerInch = dotsPerInch;
+    const HWND hWnd = createFramelessWindow();
+    WinNativeEventFilter::setWindowData(hWnd, &data);
+    if (maximized) {
+        m_backend.window(hWnd)->style |= WS_MAXIMIZE;
+    }
+    NativeEventResult result = 0;
+    QVERIFY(send(hWnd, WM_NCHITTEST, 0,
+                 makeScreenPosition(m_windowGeometry.topLeft() + pos),
+                 &result));
+    QCOMPARE(result, NativeEventResult(expected));
+}
+
+void WinNativeEventFilterTest::calcSize_data() {
+    QTest::addColumn<bool>("maximized");
+    QTest::addColumn<QRect>("geometry");
+    QTest::addColumn<int>("autoHideTaskbarEdge");
+    QTest::addColumn<QRect>("expected");
+    QTest::addColumn<int>("expectedResult");
+    // The whole window is the client area.
+    QTest::newRow("normal") << false << m_windowGeometry << -1
+                            << m_windowGeometry << WVR_REDRAW;
+    // Maximized windows stick out of the work area by the border on every
+    // side.
+    QTest::newRow("maximized")
+        << true << QRect{-8, -8, 1936, 1056} << -1
+        << QRect{0, 0, 1920, 1040} << 0;
+    QTest::newRow("maximized, auto-hide taskbar at the bottom")
+        << true << QRect{-8, -8, 1936, 1096} << ABE_BOTTOM
+        << QRect{0, 0, 1920, 1078} << 0;
+    QTest::newRow("maximized, auto-hide taskbar at the top")
+        << true << QRect{-8, -8, 1936, 1096} << ABE_TOP
+        << QRect{0, 2, 1920, 1078} << 0;
+    QTest::newRow("fullscreen") << true << QRect{0, 0, 1920, 1080} << -1
+                                << QRect{0, 0, 1920, 1080} << 0;
+}
+
+void WinNativeEventFilterTest::calcSize() {
+    QFETCH(bool, maximized);
+    QFETCH(QRect, geometry);
+    QFETCH(int, autoHideTaskbarEdge);
+    QFETCH(QRect, expected);
+    QFETCH(int, expectedResult);
+    if (autoHideTaskbarEdge >= 0) {
+        m_backend.setTaskbar(static_cast<UINT>(autoHideTaskbarEdge), true);
+    }
+    const HWND hWnd = createFramelessWindow(geometry);
+    if (maximized) {
+        m_backend.window(hWnd)->style |= WS_MAXIMIZE;
+    }
+    NCCALCSIZE_PARAMS params;
+    SecureZeroMemory(&params, sizeof(params));
+    params.rgrc[0] = toRECT(geometry);
+    NativeEventResult result = -1;
+    QVERIFY(send(hWnd, WM_NCCALCSIZE, TRUE,
+                 reinterpret_cast<LPARAM>(&params), &result));
+    QCOMPARE(fromRECT(params.rgrc[0]), expected);
+    QCOMPARE(result, NativeEventResult(expectedResult));
+    // Without NCCALCSIZE_PARAMS, lParam is the rectangle itself.
+    RECT rect = toRECT(geometry);
+    QVERIFY(send(hWnd, WM_NCCALCSIZE, FALSE, reinterpret_cast<LPARAM>(&rect),
+                 &result));
+    QCOMPARE(fromRECT(rect), expected);
+    QCOMPARE(result, NativeEventResult(0));
+}
+
+void WinNativeEventFilterTest::minMaxInfo_data() {
+    QTest::addColumn<bool>("secondMonitor");
+    QTest::addColumn<bool>("taskbarAtTop");
+    QTest::addColumn<QSize>("minimumSize");
+    QTest::addColumn<QSize>("maximumSize");
+    QTest::addColumn<QPoint>("maxPosition");
+    QTest::addColumn<QSize>("maxSize");
+    QTest::addColumn<QSize>("minTrackSize");
+    const QSize none = {-1, -1};
+    QTest::newRow("work area") << false << false << none << none
+                               << QPoint{0, 0} << QSize{1920, 1040}
+                               << QSize{0, 0};
+    // Relative to the monitor.
+    QTest::newRow("taskbar at the top")
+        << false << true << none << none << QPoint{0, 40}
+        << QSize{1920, 1040} << QSize{0, 0};
+    QTest::newRow("second monitor")
+        << true << false << none << none << QPoint{0, 0}
+        << QSize{2560, 1400} << QSize{0, 0};
+    // Device independent pixels, the second monitor has 192 DPI.
+    QTest::newRow("size limits")
+        << true << false << QSize{200, 100} << QSize{1000, 800}
+        << QPoint{0, 0} << QSize{2000, 1600} << QSize{400, 200};
+}
+
+void WinNativeEventFilterTest::minMaxInfo() {
+    QFETCH(bool, secondMonitor);
+    QFETCH(bool, taskbarAtTop);
+    QFETCH(QSize, minimumSize);
+    QFETCH(QSize, maximumSize);
+    QFETCH(QPoint, maxPosition);
+    QFETCH(QSize, maxSize);
+    QFETCH(QSize, minTrackSize);
+    if (taskbarAtTop) {
+        m_backend.setTaskbar(ABE_TOP, false);
+    }
+    QRect geometry = m_windowGeometry;
+    if (secondMonitor) {
+        m_backend.addMonitor({1920, 0, 2560, 1440}, {1920, 0, 2560, 1400},
+                             192);
+        geometry.translate(1920, 0);
+    }
+    const HWND hWnd = createFramelessWindow(geometry);
+    WinNativeEventFilter::WINDOWDATA data = {};
+    data.minimumSize = minimumSize;
+    data.maximumSize = maximumSize;
+    WinNativeEventFilter::setWindowData(hWnd, &data);
+    MINMAXINFO mmi;
+    SecureZeroMemory(&mmi, sizeof(mmi));
+    NativeEventResult result = -1;
+    QVERIFY(send(hWnd, WM_GETMINMAXINFO, 0, reinterpret_cast<LPARAM>(&mmi),
+                 &result));
+    QCOMPARE(result, NativeEventResult(0));
+    QCOMPARE(QPoint(mmi.ptMaxPosition.x, mmi.ptMaxPosition.y), maxPosition);
+    QCOMPARE(QSize(mmi.ptMaxSize.x, mmi.ptMaxSize.y), maxSize);
+    QCOMPARE(QSize(mmi.ptMaxTrackSize.x, mmi.ptMaxTrackSize.y), maxSize);
+    QCOMPARE(QSize(mmi.ptMinTrackSize.x, mmi.ptMinTrackSize.y),
+             minTrackSize);
+}
+
+void WinNativeEventFilterTest::hitTestLeavesWindowAlone() {
+    const HWND hWnd = createFramelessWindow();
+    NativeEventResult result = 0;
+    // The first message initializes the window.
+    send(hWnd, WM_NCHITTEST, 0,
+         makeScreenPosition(m_windowGeometry.center()), &result);
+    m_backend.resetCallCounts();
+    QVERIFY(send(hWnd, WM_NCHITTEST, 0,
+                 makeScreenPosition(m_windowGeometry.center()), &result));
+    // It runs for every mouse move, it must not change the window.
+    QCOMPARE(m_backend.callCount("SetWindowLongPtrW"), 0);
+    QCOMPARE(m_backend.callCount("SetWindowPos"), 0);
+    QCOMPARE(m_backend.callCount("RedrawWindow"), 0);
+    QCOMPARE(m_backend.callCount("DefWindowProcW"), 0);
+    QCOMPARE(m_backend.callCount("GetClientRect"), 1);
+    QCOMPARE(m_backend.callCount("ScreenToClient"), 1);
+}
+
+QTEST_MAIN(WinNativeEventFilterTest)
+
+#include "tst_winnativeeventfilter.moc"
@@ -0,0 +1,199 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "win32backend.h"
+#include "symbolresolver.h"
+
+#include <QDebug>
+
+namespace {
+
+Win32Backend *m_backend = nullptr;
+
+#ifndef WNEF_LINK_SYSLIB
+
+// Defines forward<funcName>, with the signature of the function in the SDK,
+// which calls the function of the installed backend.
+#ifndef FLH_WIN32_FORWARD
+#define FLH_WIN32_FORWARD(funcName, resultType, params, args)                  \
+    resultType WINAPI forward##funcName params {                               \
+        Q_ASSERT_X(m_backend, #funcName, "No Win32Backend is installed.");    \
+        return m_backend->funcName args;                                       \
+    }
+#endif
+
+FLH_WIN32_FORWARD(IsWindow, BOOL, (HWND hWnd), (hWnd))
+FLH_WIN32_FORWARD(GetWindowInfo, BOOL, (HWND hwnd, LPWINDOWINFO pwi),
+                  (hwnd, pwi))
+FLH_WIN32_FORWARD(GetWindowLongPtrW, LONG_PTR, (HWND hWnd, int nIndex),
+                  (hWnd, nIndex))
+FLH_WIN32_FORWARD(SetWindowLongPtrW, LONG_PTR,
+                  (HWND hWnd, int nIndex, LONG_PTR dwNewLong),
+                  (hWnd, nIndex, dwNewLong))
+FLH_WIN32_FORWARD(GetAncestor, HWND, (HWND hwnd, UINT gaFlags),
+                  (hwnd, gaFlags))
+FLH_WIN32_FORWARD(GetDesktopWindow, HWND, (), ())
+FLH_WIN32_FORWARD(FindWindowW, HWND,
+                  (LPCWSTR lpClassName, LPCWSTR lpWindowName),
+                  (lpClassName, lpWindowName))
+FLH_WIN32_FORWARD(IsZoomed, BOOL, (HWND hWnd), (hWnd))
+FLH_WIN32_FORWARD(GetClientRect, BOOL, (HWND hWnd, LPRECT lpRect),
+                  (hWnd, lpRect))
+FLH_WIN32_FORWARD(ScreenToClient, BOOL, (HWND hWnd, LPPOINT lpPoint),
+                  (hWnd, lpPoint))
+FLH_WIN32_FORWARD(EqualRect, BOOL, (CONST RECT *lprc1, CONST RECT *lprc2),
+                  (lprc1, lprc2))
+FLH_WIN32_FORWARD(SetWindowPos, BOOL,
+                  (HWND hWnd, HWND hWndInsertAfter, int X, int Y, int cx,
+                   int cy, UINT uFlags),
+                  (hWnd, hWndInsertAfter, X, Y, cx, cy, uFlags))
+FLH_WIN32_FORWARD(MoveWindow, BOOL,
+                  (HWND hWnd, int X, int Y, int nWidth, int nHeight,
+                   BOOL bRepaint),
+                  (hWnd, X, Y, nWidth, nHeight, bRepaint))
+FLH_WIN32_FORWARD(RedrawWindow, BOOL,
+                  (HWND hWnd, CONST RECT *lprcUpdate, HRGN hrgnUpdate,
+                   UINT flags),
+                  (hWnd, lprcUpdate, hrgnUpdate, flags))
+FLH_WIN32_FORWARD(DefWindowProcW, LRESULT,
+                  (HWND hWnd, UINT Msg, WPARAM wParam, LPARAM lParam),
+                  (hWnd, Msg, wParam, lParam))
+FLH_WIN32_FORWARD(SetLayeredWindowAttributes, BOOL,
+                  (HWND hwnd, COLORREF crKey, BYTE bAlpha, DWORD dwFlags),
+                  (hwnd, crKey, bAlpha, dwFlags))
+FLH_WIN32_FORWARD(MonitorFromWindow, HMONITOR, (HWND hwnd, DWORD dwFlags),
+                  (hwnd, dwFlags))
+FLH_WIN32_FORWARD(GetMonitorInfoW, BOOL,
+                  (HMONITOR hMonitor, LPMONITORINFO lpmi), (hMonitor, lpmi))
+FLH_WIN32_FORWARD(GetDC, HDC, (HWND hWnd), (hWnd))
+FLH_WIN32_FORWARD(ReleaseDC, int, (HWND hWnd, HDC hDC), (hWnd, hDC))
+FLH_WIN32_FORWARD(GetSystemMetrics, int, (int nIndex), (nIndex))
+FLH_WIN32_FORWARD(AdjustWindowRectEx, BOOL,
+                  (LPRECT lpRect, DWORD dwStyle, BOOL bMenu, DWORD dwExStyle),
+                  (lpRect, dwStyle, bMenu, dwExStyle))
+FLH_WIN32_FORWARD(IsProcessDPIAware, BOOL, (), ())
+FLH_WIN32_FORWARD(GetDpiForWindow, UINT, (HWND hwnd), (hwnd))
+FLH_WIN32_FORWARD(GetDpiForSystem, UINT, (), ())
+FLH_WIN32_FORWARD(GetSystemMetricsForDpi, int, (int nIndex, UINT dpi),
+                  (nIndex, dpi))
+FLH_WIN32_FORWARD(AdjustWindowRectExForDpi, BOOL,
+                  (LPRECT lpRect, DWORD dwStyle, BOOL bMenu, DWORD dwExStyle,
+                   UINT dpi),
+                  (lpRect, dwStyle, bMenu, dwExStyle, dpi))
+FLH_WIN32_FORWARD(GetSystemDpiForProcess, UINT, (HANDLE hProcess),
+                  (hProcess))
+FLH_WIN32_FORWARD(GetDeviceCaps, int, (HDC hdc, int index), (hdc, index))
+FLH_WIN32_FORWARD(SHAppBarMessage, UINT_PTR,
+                  (DWORD dwMessage, APPBARDATA *pData), (dwMessage, pData))
+FLH_WIN32_FORWARD(GetCurrentProcess, HANDLE, (), ())
+FLH_WIN32_FORWARD(DwmIsCompositionEnabled, HRESULT, (BOOL *pfEnabled),
+                  (pfEnabled))
+FLH_WIN32_FORWARD(DwmExtendFrameIntoClientArea, HRESULT,
+                  (HWND hWnd, CONST MARGINS *pMarInset), (hWnd, pMarInset))
+FLH_WIN32_FORWARD(DwmSetWindowAttribute, HRESULT,
+                  (HWND hwnd, DWORD dwAttribute, LPCVOID pvAttribute,
+                   DWORD cbAttribute),
+                  (hwnd, dwAttribute, pvAttribute, cbAttribute))
+FLH_WIN32_FORWARD(GetDpiForMonitor, HRESULT,
+                  (HMONITOR hmonitor, MONITOR_DPI_TYPE dpiType, UINT *dpiX,
+                   UINT *dpiY),
+                  (hmonitor, dpiType, dpiX, dpiY))
+FLH_WIN32_FORWARD(GetProcessDpiAwareness, HRESULT,
+                  (HANDLE hprocess, PROCESS_DPI_AWARENESS *value),
+                  (hprocess, value))
+
+#endif
+
+} // namespace
+
+void Win32Backend::install(Win32Backend *backend) {
+#ifdef WNEF_LINK_SYSLIB
+    Q_UNUSED(backend)
+    qWarning().noquote() << "WinNativeEventFilter calls the Win32 API "
+                            "directly (WNEF_LINK_SYSLIB), a Win32Backend "
+                            "can't replace it.";
+#else
+    m_backend = backend;
+    // A null function removes the override again.
+    const auto setOverride = [backend](const char *library,
+                                       const char *symbol,
+                                       QFunctionPointer function) {
+        SymbolResolver::setOverride(QString::fromUtf8(library), symbol,
+                                    backend ? function : nullptr);
+    };
+#ifndef FLH_WIN32_OVERRIDE
+#define FLH_WIN32_OVERRIDE(libName, funcName)                                  \
+    setOverride(#libName, #funcName,                                           \
+                reinterpret_cast<QFunctionPointer>(&forward##funcName));
+#endif
+    FLH_WIN32_OVERRIDE(User32, IsWindow)
+    FLH_WIN32_OVERRIDE(User32, GetWindowInfo)
+#if (QT_POINTER_SIZE == 8)
+    FLH_WIN32_OVERRIDE(User32, GetWindowLongPtrW)
+    FLH_WIN32_OVERRIDE(User32, SetWindowLongPtrW)
+#else
+    // The filter uses these in 32 bit builds, there are no *LongPtr
+    // functions in 32 bit User32.dll.
+    setOverride("User32", "GetWindowLongW",
+                reinterpret_cast<QFunctionPointer>(&forwardGetWindowLongPtrW));
+    setOverride("User32", "SetWindowLongW",
+                reinterpret_cast<QFunctionPointer>(&forwardSetWindowLongPtrW));
+#endif
+    FLH_WIN32_OVERRIDE(User32, GetAncestor)
+    FLH_WIN32_OVERRIDE(User32, GetDesktopWindow)
+    FLH_WIN32_OVERRIDE(User32, FindWindowW)
+    FLH_WIN32_OVERRIDE(User32, IsZoomed)
+    FLH_WIN32_OVERRIDE(User32, GetClientRect)
+    FLH_WIN32_OVERRIDE(User32, ScreenToClient)
+    FLH_WIN32_OVERRIDE(User32, EqualRect)
+    FLH_WIN32_OVERRIDE(User32, SetWindowPos)
+    FLH_WIN32_OVERRIDE(User32, MoveWindow)
+    FLH_WIN32_OVERRIDE(User32, RedrawWindow)
+    FLH_WIN32_OVERRIDE(User32, DefWindowProcW)
+    FLH_WIN32_OVERRIDE(User32, SetLayeredWindowAttributes)
+    FLH_WIN32_OVERRIDE(User32, MonitorFromWindow)
+    FLH_WIN32_OVERRIDE(User32, GetMonitorInfoW)
+    FLH_WIN32_OVERRIDE(User32, GetDC)
+    FLH_WIN32_OVERRIDE(User32, ReleaseDC)
+    FLH_WIN32_OVERRIDE(User32, GetSystemMetrics)
+    FLH_WIN32_OVERRIDE(User32, AdjustWindowRectEx)
+    FLH_WIN32_OVERRIDE(User32, IsProcessDPIAware)
+    FLH_WIN32_OVERRIDE(User32, GetDpiForWindow)
+    FLH_WIN32_OVERRIDE(User32, GetDpiForSystem)
+    FLH_WIN32_OVERRIDE(User32, GetSystemMetricsForDpi)
+    FLH_WIN32_OVERRIDE(User32, AdjustWindowRectExForDpi)
+    FLH_WIN32_OVERRIDE(User32, GetSystemDpiForProcess)
+    FLH_WIN32_OVERRIDE(Gdi32, GetDeviceCaps)
+    FLH_WIN32_OVERRIDE(Shell32, SHAppBarMessage)
+    FLH_WIN32_OVERRIDE(Kernel32, GetCurrentProcess)
+    FLH_WIN32_OVERRIDE(Dwmapi, DwmIsCompositionEnabled)
+    FLH_WIN32_OVERRIDE(Dwmapi, DwmExtendFrameIntoClientArea)
+    FLH_WIN32_OVERRIDE(Dwmapi, DwmSetWindowAttribute)
+    FLH_WIN32_OVERRIDE(SHCore, GetDpiForMonitor)
+    FLH_WIN32_OVERRIDE(SHCore, GetProcessDpiAwareness)
+#endif
+}
+
+Win32Backend *Win32Backend::installed() { return m_backend; }
@@ -0,0 +1,164 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#include <QtGlobal>
+#include <qt_windows.h>
+#ifdef WNEF_LINK_SYSLIB
+#include <dwmapi.h>
+#include <shellapi.h>
+#include <shellscalingapi.h>
+#else
+
+// The types of the functions below which are not in windows.h, copied from
+// the Windows 10 SDK directly, without any modifications.
+
+using MONITOR_DPI_TYPE = enum _MONITOR_DPI_TYPE { MDT_EFFECTIVE_DPI = 0 };
+
+using MARGINS = struct _MARGINS {
+    int cxLeftWidth;
+    int cxRightWidth;
+    int cyTopHeight;
+    int cyBottomHeight;
+};
+
+using APPBARDATA = struct _APPBARDATA {
+    DWORD cbSize;
+    HWND hWnd;
+    UINT uCallbackMessage;
+    UINT uEdge;
+    RECT rc;
+    LPARAM lParam;
+};
+
+using PROCESS_DPI_AWARENESS = enum _PROCESS_DPI_AWARENESS {
+    PROCESS_DPI_UNAWARE = 0,
+    PROCESS_SYSTEM_DPI_AWARE = 1,
+    PROCESS_PER_MONITOR_DPI_AWARE = 2
+};
+
+#endif
+
+#if (QT_VERSION < QT_VERSION_CHECK(5, 13, 0))
+#define Q_DISABLE_MOVE(Class)                                                  \
+    Class(Class &&) = delete;                                                  \
+    Class &operator=(Class &&) = delete;
+
+#define Q_DISABLE_COPY_MOVE(Class)                                             \
+    Q_DISABLE_COPY(Class)                                                      \
+    Q_DISABLE_MOVE(Class)
+#endif
+
+// Every Win32 function WinNativeEventFilter calls, with the signatures of the
+// SDK. install() puts a backend between the filter and the system libraries:
+// the filter resolves functions which forward to the backend instead of the
+// ones of User32, Dwmapi and the others. A fake of the Win32 API is the main
+// user, it runs the filter on any platform (see tests/win32fake).
+// Install the backend before the first WinNativeEventFilter is created or any
+// of its static functions is called, the filter resolves the functions only
+// once. Another backend can be installed later, the filter keeps calling the
+// installed one. Don't install nullptr while the filter is still in use.
+// Without effect if the filter calls the system libraries directly
+// (WNEF_LINK_SYSLIB).
+class Win32Backend {
+    Q_DISABLE_COPY_MOVE(Win32Backend)
+
+public:
+    explicit Win32Backend() = default;
+    virtual ~Win32Backend() = default;
+
+    static void install(Win32Backend *backend);
+    static Win32Backend *installed();
+
+    // User32
+    virtual BOOL IsWindow(HWND hWnd) = 0;
+    virtual BOOL GetWindowInfo(HWND hwnd, LPWINDOWINFO pwi) = 0;
+    virtual LONG_PTR GetWindowLongPtrW(HWND hWnd, int nIndex) = 0;
+    virtual LONG_PTR SetWindowLongPtrW(HWND hWnd, int nIndex,
+                                       LONG_PTR dwNewLong) = 0;
+    virtual HWND GetAncestor(HWND hwnd, UINT gaFlags) = 0;
+    virtual HWND GetDesktopWindow() = 0;
+    virtual HWND FindWindowW(LPCWSTR lpClassName, LPCWSTR lpWindowName) = 0;
+    virtual BOOL IsZoomed(HWND hWnd) = 0;
+    virtual BOOL GetClientRect(HWND hWnd, LPRECT lpRect) = 0;
+    virtual BOOL ScreenToClient(HWND hWnd, LPPOINT lpPoint) = 0;
+    virtual BOOL EqualRect(CONST RECT *lprc1, CONST RECT *lprc2) = 0;
+    virtual BOOL SetWindowPos(HWND hWnd, HWND hWndInsertAfter, int X, int Y,
+                              int cx, int cy, UINT uFlags) = 0;
+    virtual BOOL MoveWindow(HWND hWnd, int X, int Y, int nWidth, int nHeight,
+                            BOOL bRepaint) = 0;
+    virtual BOOL RedrawWindow(HWND hWnd, CONST RECT *lprcUpdate,
+                              HRGN hrgnUpdate, UINT flags) = 0;
+    virtual LRESULT DefWindowProcW(HWND hWnd, UINT Msg, WPARAM wParam,
+                                   LPARAM lParam) = 0;
+    virtual BOOL SetLayeredWindowAttributes(HWND hwnd, COLORREF crKey,
+                                            BYTE bAlpha, DWORD dwFlags) = 0;
+    virtual HMONITOR MonitorFromWindow(HWND hwnd, DWORD dwFlags) = 0;
+    virtual BOOL GetMonitorInfoW(HMONITOR hMonitor, LPMONITORINFO lpmi) = 0;
+    virtual HDC GetDC(HWND hWnd) = 0;
+    virtual int ReleaseDC(HWND hWnd, HDC hDC) = 0;
+    virtual int GetSystemMetrics(int nIndex) = 0;
+    virtual BOOL AdjustWindowRectEx(LPRECT lpRect, DWORD dwStyle, BOOL bMenu,
+                                    DWORD dwExStyle) = 0;
+    virtual BOOL IsProcessDPIAware() = 0;
+    // User32, Windows 10 1607 and newer
+    virtual UINT GetDpiForWindow(HWND hwnd) = 0;
+    virtual UINT GetDpiForSystem() = 0;
+    virtual int GetSystemMetricsForDpi(int nIndex, UINT dpi) = 0;
+    virtual BOOL AdjustWindowRectExForDpi(LPRECT lpRect, DWORD dwStyle,
+                                          BOOL bMenu, DWORD dwExStyle,
+                                          UINT dpi) = 0;
+    // User32, Windows 10 1803 and newer
+    virtual UINT GetSystemDpiForProcess(HANDLE hProcess) = 0;
+    // Gdi32
+    virtual int GetDeviceCaps(HDC hdc, int index) = 0;
+    // Shell32
+    virtual UINT_PTR SHAppBarMessage(DWORD dwMessage, APPBARDATA *pData) = 0;
+    // Kernel32
+    virtual HANDLE GetCurrentProcess() = 0;
+    // Dwmapi
+    virtual HRESULT DwmIsCompositionEnabled(BOOL *pfEnabled) = 0;
+    virtual HRESULT DwmExtendFrameIntoClientArea(HWND hWnd,
+                                                 CONST MARGINS *pMarInset) = 0;
+    virtual HRESULT DwmSetWindowAttribute(HWND hwnd, DWORD dwAttribute,
+                                          LPCVOID pvAttribute,
+                                          DWORD cbAttribute) = 0;
+    // SHCore, Windows 8.1 and newer
+    virtual HRESULT GetDpiForMonitor(HMONITOR hmonitor,
+                                     MONITOR_DPI_TYPE dpiType, UINT *dpiX,
+                                     UINT *dpiY) = 0;
+    virtual HRESULT GetProcessDpiAwareness(HANDLE hprocess,
+                                           PROCESS_DPI_AWARENESS *value) = 0;
+    // Ntdll, the version of Windows the backend pretends to be. Built for
+    // another platform, the filter asks it instead of Qt whenever it checks
+    // the version. The functions of newer versions of Windows are resolved
+    // only once though, with the version of the backend installed then.
+    virtual LONG RtlGetVersion(PRTL_OSVERSIONINFOW lpVersionInformation) = 0;
+};
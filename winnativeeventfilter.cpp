@@ -23,10 +23,11 @@
  */
 
 #include "winnativeeventfilter.h"
+#include "symbolresolver.h"
+#include "win32backend.h"
 
 #include <QDebug>
 #include <QGuiApplication>
-#include <QLibrary>
 #include <QMargins>
 #include <QWindow>
 #include <qpa/qplatformnativeinterface.h>
@@ -96,8 +97,35 @@ const UINT m_defaultDotsPerInch = USER_DEFAULT_SCREEN_DPI;
 
 const qreal m_defaultDevicePixelRatio = 1.0;
 
+#ifndef Q_OS_WINDOWS
+// Built on another platform, the filter runs against a fake of the Win32 API
+// (see win32backend.h), which has the version of Windows it pretends to be.
+bool isBackendVersionOrGreater(const DWORD major, const DWORD minor,
+                               const DWORD build) {
+    Win32Backend *const backend = Win32Backend::installed();
+    if (!backend) {
+        return false;
+    }
+    RTL_OSVERSIONINFOW versionInfo;
+    SecureZeroMemory(&versionInfo, sizeof(versionInfo));
+    versionInfo.dwOSVersionInfoSize = sizeof(versionInfo);
+    if (backend->RtlGetVersion(&versionInfo) != 0) {
+        return false;
+    }
+    if (versionInfo.dwMajorVersion != major) {
+        return versionInfo.dwMajorVersion > major;
+    }
+    if (versionInfo.dwMinorVersion != minor) {
+        return versionInfo.dwMinorVersion > minor;
+    }
+    return versionInfo.dwBuildNumber >= build;
+}
+#endif
+
 bool isWin8OrGreator() {
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 9, 0))
+#ifndef Q_OS_WINDOWS
+    return isBackendVersionOrGreater(6, 2, 0);
+#elif (QT_VERSION >= QT_VERSION_CHECK(5, 9, 0))
     return QOperatingSystemVersion::current() >=
         QOperatingSystemVersion::Windows8;
 #else
@@ -106,7 +134,9 @@ bool isWin8OrGreator() {
 }
 
 bool isWin8Point1OrGreator() {
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 9, 0))
+#ifndef Q_OS_WINDOWS
+    return isBackendVersionOrGreater(6, 3, 0);
+#elif (QT_VERSION >= QT_VERSION_CHECK(5, 9, 0))
     return QOperatingSystemVersion::current() >=
         QOperatingSystemVersion::Windows8_1;
 #else
@@ -115,7 +145,9 @@ bool isWin8Point1OrGreator() {
 }
 
 bool isWin10OrGreator(const int ver) {
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 9, 0))
+#ifndef Q_OS_WINDOWS
+    return isBackendVersionOrGreater(10, 0, static_cast<DWORD>(ver));
+#elif (QT_VERSION >= QT_VERSION_CHECK(5, 9, 0))
     return QOperatingSystemVersion::current() >=
         QOperatingSystemVersion(QOperatingSystemVersion::Windows, 10, 0, ver);
 #else
@@ -133,7 +165,7 @@ bool isWin10OrGreator(const int ver) {
 #ifndef WNEF_SYSTEM_LIB_BEGIN
 #define WNEF_SYSTEM_LIB_BEGIN(libName)                                         \
     {                                                                          \
-        QLibrary library(QString::fromUtf8(#libName));
+        const QString library = QString::fromUtf8(#libName);
 #endif
 
 #ifndef WNEF_SYSTEM_LIB_END
@@ -144,9 +176,9 @@ bool isWin10OrGreator(const int ver) {
 #define WNEF_RESOLVE_WINAPI(funcName)                                          \
     if (!m_lp##funcName) {                                                     \
         m_lp##funcName = reinterpret_cast<_WNEF_WINAPI_##funcName>(            \
-            library.resolve(#funcName));                                       \
+            SymbolResolver::resolve(library, -1, #funcName));                  \
         Q_ASSERT_X(m_lp##funcName, __FUNCTION__,                               \
-                   qUtf8Printable(library.errorString()));                     \
+                   qUtf8Printable(SymbolResolver::errorString(library, -1)));  \
     }
 #endif
 
@@ -184,19 +216,13 @@ bool isWin10OrGreator(const int ver) {
 #else
 
 // All the following enums, structs and function prototypes are copied from
-// Windows 10 SDK directly, without any modifications.
-
-#ifdef IsMinimized
-#undef IsMinimized
-#endif
+// Windows 10 SDK directly, without any modifications. The types used by the
+// functions of Win32Backend are in win32backend.h.
 
 #ifdef IsMaximized
 #undef IsMaximized
 #endif
 
-// Only available since Windows 2000
-#define IsMinimized m_lpIsIconic
-
 // Only available since Windows 2000
 #define IsMaximized m_lpIsZoomed
 
@@ -210,11 +236,6 @@ bool isWin10OrGreator(const int ver) {
 #define GET_Y_LPARAM(lp) ((int)(short)HIWORD(lp))
 #endif
 
-#ifndef GetStockBrush
-// Only available since Windows 2000
-#define GetStockBrush(i) ((HBRUSH)m_lpGetStockObject(i))
-#endif
-
 #ifndef ABM_GETSTATE
 // Only available since Windows XP
 #define ABM_GETSTATE 0x00000004
@@ -250,67 +271,12 @@ bool isWin10OrGreator(const int ver) {
 #define ABE_BOTTOM 3
 #endif
 
-#ifndef BPPF_ERASE
-// Only available since Windows Vista
-#define BPPF_ERASE 0x0001
-#endif
-
-#ifndef BPPF_NOCLIP
-// Only available since Windows Vista
-#define BPPF_NOCLIP 0x0002
-#endif
-
-using HPAINTBUFFER = HANDLE;
-
-using MONITOR_DPI_TYPE = enum _MONITOR_DPI_TYPE { MDT_EFFECTIVE_DPI = 0 };
-
 using DWMNCRENDERINGPOLICY = enum _DWMNCRENDERINGPOLICY { DWMNCRP_ENABLED = 2 };
 
 using DWMWINDOWATTRIBUTE = enum _DWMWINDOWATTRIBUTE {
-    DWMWA_NCRENDERING_POLICY = 2,
-    DWMWA_EXTENDED_FRAME_BOUNDS = 9
-};
-
-using MARGINS = struct _MARGINS {
-    int cxLeftWidth;
-    int cxRightWidth;
-    int cyTopHeight;
-    int cyBottomHeight;
-};
-
-using APPBARDATA = struct _APPBARDATA {
-    DWORD cbSize;
-    HWND hWnd;
-    UINT uCallbackMessage;
-    UINT uEdge;
-    RECT rc;
-    LPARAM lParam;
-};
-
-using PROCESS_DPI_AWARENESS = enum _PROCESS_DPI_AWARENESS {
-    PROCESS_DPI_UNAWARE = 0,
-    PROCESS_SYSTEM_DPI_AWARE = 1,
-    PROCESS_PER_MONITOR_DPI_AWARE = 2
-};
-
-using BP_BUFFERFORMAT = enum _BP_BUFFERFORMAT { BPBF_TOPDOWNDIB = 2 };
-
-using BLENDFUNCTION = struct _BLENDFUNCTION {
-    BYTE BlendOp;
-    BYTE BlendFlags;
-    BYTE SourceConstantAlpha;
-    BYTE AlphaFormat;
-};
-
-using BP_PAINTPARAMS = struct _BP_PAINTPARAMS {
-    DWORD cbSize;
-    DWORD dwFlags;
-    CONST RECT *prcExclude;
-    CONST BLENDFUNCTION *pBlendFunction;
+    DWMWA_NCRENDERING_POLICY = 2
 };
 
-// Some of the following functions are not used by this code anymore,
-// but we don't remove them completely because we may still need them later.
 WNEF_GENERATE_WINAPI(DwmExtendFrameIntoClientArea, HRESULT, HWND,
                      CONST MARGINS *)
 WNEF_GENERATE_WINAPI(DwmIsCompositionEnabled, HRESULT, BOOL *)
@@ -323,20 +289,16 @@ WNEF_GENERATE_WINAPI(SetLayeredWindowAttributes, BOOL, HWND, COLORREF, BYTE,
                      DWORD)
 WNEF_GENERATE_WINAPI(MoveWindow, BOOL, HWND, int, int, int, int, BOOL)
 WNEF_GENERATE_WINAPI(IsZoomed, BOOL, HWND)
-WNEF_GENERATE_WINAPI(IsIconic, BOOL, HWND)
 WNEF_GENERATE_WINAPI(GetSystemMetrics, int, int)
 WNEF_GENERATE_WINAPI(GetDC, HDC, HWND)
 WNEF_GENERATE_WINAPI(ReleaseDC, int, HWND, HDC)
 WNEF_GENERATE_WINAPI(RedrawWindow, BOOL, HWND, CONST RECT *, HRGN, UINT)
 WNEF_GENERATE_WINAPI(GetClientRect, BOOL, HWND, LPRECT)
-WNEF_GENERATE_WINAPI(GetWindowRect, BOOL, HWND, LPRECT)
 WNEF_GENERATE_WINAPI(ScreenToClient, BOOL, HWND, LPPOINT)
 WNEF_GENERATE_WINAPI(EqualRect, BOOL, CONST RECT *, CONST RECT *)
-#ifdef Q_PROCESSOR_X86_64
+#if (QT_POINTER_SIZE == 8)
 WNEF_GENERATE_WINAPI(GetWindowLongPtrW, LONG_PTR, HWND, int)
 WNEF_GENERATE_WINAPI(SetWindowLongPtrW, LONG_PTR, HWND, int, LONG_PTR)
-WNEF_GENERATE_WINAPI(GetClassLongPtrW, ULONG_PTR, HWND, int)
-WNEF_GENERATE_WINAPI(SetClassLongPtrW, ULONG_PTR, HWND, int, LONG_PTR)
 #else
 #ifdef LONG_PTR
 #undef LONG_PTR
@@ -350,53 +312,18 @@ WNEF_GENERATE_WINAPI(SetWindowLongW, LONG_PTR, HWND, int, LONG_PTR)
 #undef GWLP_USERDATA
 #endif
 #define GWLP_USERDATA GWL_USERDATA
-WNEF_GENERATE_WINAPI(GetClassLongW, DWORD, HWND, int)
-WNEF_GENERATE_WINAPI(SetClassLongW, DWORD, HWND, int, LONG_PTR)
-#define m_lpGetClassLongPtrW m_lpGetClassLongW
-#define m_lpSetClassLongPtrW m_lpSetClassLongW
-#ifdef GCLP_HBRBACKGROUND
-#undef GCLP_HBRBACKGROUND
-#endif
-#define GCLP_HBRBACKGROUND GCL_HBRBACKGROUND
 #endif
 WNEF_GENERATE_WINAPI(FindWindowW, HWND, LPCWSTR, LPCWSTR)
 WNEF_GENERATE_WINAPI(MonitorFromWindow, HMONITOR, HWND, DWORD)
 WNEF_GENERATE_WINAPI(GetMonitorInfoW, BOOL, HMONITOR, LPMONITORINFO)
 WNEF_GENERATE_WINAPI(GetAncestor, HWND, HWND, UINT)
 WNEF_GENERATE_WINAPI(GetDesktopWindow, HWND)
-WNEF_GENERATE_WINAPI(SendMessageW, LRESULT, HWND, UINT, WPARAM, LPARAM)
 WNEF_GENERATE_WINAPI(SetWindowPos, BOOL, HWND, HWND, int, int, int, int, UINT)
-WNEF_GENERATE_WINAPI(UpdateWindow, BOOL, HWND)
-WNEF_GENERATE_WINAPI(InvalidateRect, BOOL, HWND, CONST RECT *, BOOL)
-WNEF_GENERATE_WINAPI(SetWindowRgn, int, HWND, HRGN, BOOL)
 WNEF_GENERATE_WINAPI(IsWindow, BOOL, HWND)
 WNEF_GENERATE_WINAPI(GetWindowInfo, BOOL, HWND, LPWINDOWINFO)
-WNEF_GENERATE_WINAPI(CreateSolidBrush, HBRUSH, COLORREF)
-WNEF_GENERATE_WINAPI(FillRect, int, HDC, CONST RECT *, HBRUSH)
-WNEF_GENERATE_WINAPI(DeleteObject, BOOL, HGDIOBJ)
-WNEF_GENERATE_WINAPI(IsThemeActive, BOOL)
-WNEF_GENERATE_WINAPI(BeginPaint, HDC, HWND, LPPAINTSTRUCT)
-WNEF_GENERATE_WINAPI(EndPaint, BOOL, HWND, CONST PAINTSTRUCT *)
 WNEF_GENERATE_WINAPI(GetCurrentProcess, HANDLE)
 WNEF_GENERATE_WINAPI(IsProcessDPIAware, BOOL)
-#if 0
-WNEF_GENERATE_WINAPI(D2D1CreateFactory, HRESULT, D2D1_FACTORY_TYPE, REFIID,
-                     CONST D2D1_FACTORY_OPTIONS *, void **)
-#endif
 WNEF_GENERATE_WINAPI(AdjustWindowRectEx, BOOL, LPRECT, DWORD, BOOL, DWORD)
-WNEF_GENERATE_WINAPI(DwmDefWindowProc, BOOL, HWND, UINT, WPARAM, LPARAM,
-                     LRESULT *)
-WNEF_GENERATE_WINAPI(DwmGetWindowAttribute, HRESULT, HWND, DWORD, PVOID, DWORD)
-WNEF_GENERATE_WINAPI(GetStockObject, HGDIOBJ, int)
-WNEF_GENERATE_WINAPI(BufferedPaintSetAlpha, HRESULT, HPAINTBUFFER, CONST RECT *,
-                     BYTE)
-WNEF_GENERATE_WINAPI(EndBufferedPaint, HRESULT, HPAINTBUFFER, BOOL)
-WNEF_GENERATE_WINAPI(BeginBufferedPaint, HPAINTBUFFER, HDC, CONST RECT *,
-                     BP_BUFFERFORMAT, BP_PAINTPARAMS *, HDC *)
-WNEF_GENERATE_WINAPI(CreateRectRgnIndirect, HRGN, CONST RECT *)
-WNEF_GENERATE_WINAPI(GetDCEx, HDC, HWND, HRGN, DWORD)
-WNEF_GENERATE_WINAPI(GetWindowDC, HDC, HWND)
-WNEF_GENERATE_WINAPI(OffsetRect, BOOL, LPRECT, int, int)
 
 #endif
 
@@ -457,7 +384,9 @@ void ResolveWin32APIs() {
 #else
 
 // Some APIs are not available on old systems, so we will load them
-// dynamically at run-time to get maximum compatibility.
+// dynamically at run-time to get maximum compatibility. They can be replaced
+// with SymbolResolver::setOverride() (by a fake of the Win32 API, to feed
+// synthetic messages through the filter) before they are resolved here.
 void ResolveWin32APIs() {
     static bool resolved = false;
     if (resolved) {
@@ -465,48 +394,34 @@ void ResolveWin32APIs() {
         return;
     }
     resolved = true;
+    // Only the functions the filter calls, Win32Backend has to provide all
+    // of them.
     // Available since Windows 2000.
     WNEF_SYSTEM_LIB_BEGIN(User32)
-    WNEF_RESOLVE_WINAPI(OffsetRect)
-    WNEF_RESOLVE_WINAPI(GetWindowDC)
-    WNEF_RESOLVE_WINAPI(GetDCEx)
     WNEF_RESOLVE_WINAPI(AdjustWindowRectEx)
-    WNEF_RESOLVE_WINAPI(EndPaint)
-    WNEF_RESOLVE_WINAPI(BeginPaint)
-    WNEF_RESOLVE_WINAPI(FillRect)
     WNEF_RESOLVE_WINAPI(GetWindowInfo)
     WNEF_RESOLVE_WINAPI(IsWindow)
-    WNEF_RESOLVE_WINAPI(SetWindowRgn)
-    WNEF_RESOLVE_WINAPI(InvalidateRect)
-    WNEF_RESOLVE_WINAPI(UpdateWindow)
     WNEF_RESOLVE_WINAPI(SetWindowPos)
-    WNEF_RESOLVE_WINAPI(SendMessageW)
     WNEF_RESOLVE_WINAPI(GetDesktopWindow)
     WNEF_RESOLVE_WINAPI(GetAncestor)
     WNEF_RESOLVE_WINAPI(DefWindowProcW)
     WNEF_RESOLVE_WINAPI(SetLayeredWindowAttributes)
     WNEF_RESOLVE_WINAPI(MoveWindow)
     WNEF_RESOLVE_WINAPI(IsZoomed)
-    WNEF_RESOLVE_WINAPI(IsIconic)
     WNEF_RESOLVE_WINAPI(GetSystemMetrics)
     WNEF_RESOLVE_WINAPI(GetDC)
     WNEF_RESOLVE_WINAPI(ReleaseDC)
     WNEF_RESOLVE_WINAPI(RedrawWindow)
     WNEF_RESOLVE_WINAPI(GetClientRect)
-    WNEF_RESOLVE_WINAPI(GetWindowRect)
     WNEF_RESOLVE_WINAPI(ScreenToClient)
     WNEF_RESOLVE_WINAPI(EqualRect)
-#ifdef Q_PROCESSOR_X86_64
+#if (QT_POINTER_SIZE == 8)
     // These functions only exist in 64 bit User32.dll
     WNEF_RESOLVE_WINAPI(GetWindowLongPtrW)
     WNEF_RESOLVE_WINAPI(SetWindowLongPtrW)
-    WNEF_RESOLVE_WINAPI(GetClassLongPtrW)
-    WNEF_RESOLVE_WINAPI(SetClassLongPtrW)
 #else
     WNEF_RESOLVE_WINAPI(GetWindowLongW)
     WNEF_RESOLVE_WINAPI(SetWindowLongW)
-    WNEF_RESOLVE_WINAPI(GetClassLongW)
-    WNEF_RESOLVE_WINAPI(SetClassLongW)
 #endif
     WNEF_RESOLVE_WINAPI(FindWindowW)
     WNEF_RESOLVE_WINAPI(MonitorFromWindow)
@@ -514,10 +429,6 @@ void ResolveWin32APIs() {
     WNEF_SYSTEM_LIB_END
     WNEF_SYSTEM_LIB_BEGIN(Gdi32)
     WNEF_RESOLVE_WINAPI(GetDeviceCaps)
-    WNEF_RESOLVE_WINAPI(CreateSolidBrush)
-    WNEF_RESOLVE_WINAPI(DeleteObject)
-    WNEF_RESOLVE_WINAPI(GetStockObject)
-    WNEF_RESOLVE_WINAPI(CreateRectRgnIndirect)
     WNEF_SYSTEM_LIB_END
     // Available since Windows XP.
     WNEF_SYSTEM_LIB_BEGIN(Shell32)
@@ -531,24 +442,10 @@ void ResolveWin32APIs() {
     WNEF_RESOLVE_WINAPI(IsProcessDPIAware)
     WNEF_SYSTEM_LIB_END
     WNEF_SYSTEM_LIB_BEGIN(Dwmapi)
-    WNEF_RESOLVE_WINAPI(DwmGetWindowAttribute)
     WNEF_RESOLVE_WINAPI(DwmIsCompositionEnabled)
     WNEF_RESOLVE_WINAPI(DwmExtendFrameIntoClientArea)
     WNEF_RESOLVE_WINAPI(DwmSetWindowAttribute)
-    WNEF_RESOLVE_WINAPI(DwmDefWindowProc)
-    WNEF_SYSTEM_LIB_END
-    WNEF_SYSTEM_LIB_BEGIN(UxTheme)
-    WNEF_RESOLVE_WINAPI(IsThemeActive)
-    WNEF_RESOLVE_WINAPI(BufferedPaintSetAlpha)
-    WNEF_RESOLVE_WINAPI(EndBufferedPaint)
-    WNEF_RESOLVE_WINAPI(BeginBufferedPaint)
     WNEF_SYSTEM_LIB_END
-    // Available since Windows 7.
-#if 0
-    WNEF_SYSTEM_LIB_BEGIN(D2D1)
-    WNEF_RESOLVE_WINAPI(D2D1CreateFactory)
-    WNEF_SYSTEM_LIB_END
-#endif
     loadDPIFunctions();
 }
 
@@ -615,23 +512,6 @@ BOOL IsTopLevel(const HWND handle) {
 
 UINT GetDotsPerInchForWindow(const HWND handle) {
     const auto getScreenDpi = [](const UINT defaultValue) -> UINT {
-#if 0
-        if (m_lpD2D1CreateFactory) {
-            // Using Direct2D to get the screen DPI.
-            // Available since Windows 7.
-            ID2D1Factory *m_pDirect2dFactory = nullptr;
-            if (SUCCEEDED(m_lpD2D1CreateFactory(
-                    D2D1_FACTORY_TYPE_SINGLE_THREADED, __uuidof(ID2D1Factory),
-                    nullptr, reinterpret_cast<void **>(&m_pDirect2dFactory))) &&
-                m_pDirect2dFactory) {
-                m_pDirect2dFactory->ReloadSystemMetrics();
-                FLOAT dpiX = defaultValue, dpiY = defaultValue;
-                m_pDirect2dFactory->GetDesktopDpi(&dpiX, &dpiY);
-                // The values of *dpiX and *dpiY are identical.
-                return qRound(dpiX);
-            }
-        }
-#endif
         // Available since Windows 2000.
         const HDC hdc = m_lpGetDC(nullptr);
         if (hdc) {
@@ -1743,20 +1623,24 @@ void WinNativeEventFilter::moveWindowToDesktopCenter(const HWND handle) {
     ResolveWin32APIs();
     if (handle && m_lpIsWindow(handle)) {
         const WINDOWINFO windowInfo = GetInfoForWindow(handle);
+        // One GetMonitorInfo call per centring, not worth a cache that has
+        // to follow WM_DISPLAYCHANGE and WM_SETTINGCHANGE (the work area
+        // changes whenever the task bar is moved or resized).
         const MONITORINFO monitorInfo = GetMonitorInfoForWindow(handle);
-        // If we want to move a window to the center of the desktop,
-        // I think we should use rcMonitor, the monitor's whole area,
-        // to calculate the new coordinates of our window, not rcWork.
-        const LONG mw =
-            qAbs(monitorInfo.rcMonitor.right - monitorInfo.rcMonitor.left);
-        const LONG mh =
-            qAbs(monitorInfo.rcMonitor.bottom - monitorInfo.rcMonitor.top);
+        // Centre in the work area, the same as FramelessHelper does with
+        // QScreen::availableGeometry(), so that the task bar and the other
+        // app bars don't cover a part of the window.
+        const RECT rcWork = monitorInfo.rcWork;
+        const LONG mw = qAbs(rcWork.right - rcWork.left);
+        const LONG mh = qAbs(rcWork.bottom - rcWork.top);
         const LONG ww =
             qAbs(windowInfo.rcWindow.right - windowInfo.rcWindow.left);
         const LONG wh =
             qAbs(windowInfo.rcWindow.bottom - windowInfo.rcWindow.top);
-        m_lpMoveWindow(handle, qRound((mw - ww) / 2.0), qRound((mh - wh) / 2.0),
-                       ww, wh, TRUE);
+        // Take the origin of the work area into account, otherwise the
+        // window will jump to the primary monitor.
+        m_lpMoveWindow(handle, rcWork.left + qRound((mw - ww) / 2.0),
+                       rcWork.top + qRound((mh - wh) / 2.0), ww, wh, TRUE);
     }
 }
 
@@ -0,0 +1,618 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "x11nativeeventfilter.h"
+#include "framelesshelper.h"
+#include "symbolresolver.h"
+
+#include <QGuiApplication>
+#include <QStyleHints>
+#include <QWindow>
+#include <QtGui/private/qhighdpiscaling_p.h>
+#ifdef FLH_HAVE_XCB
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+#include <qpa/qplatformnativeinterface.h>
+#include <qpa/qwindowsysteminterface.h>
+#include <cstdlib>
+#include <xcb/xcb.h>
+#ifdef FLH_HAVE_XCB_SHAPE
+#include <xcb/shape.h>
+#endif
+#ifdef FLH_HAVE_XCB_XINPUT
+#include <xcb/xinput.h>
+#endif
+#endif
+
+#ifdef FLH_HAVE_XCB
+
+namespace {
+
+// libxcb is loaded by Qt's xcb platform plugin anyway, we only bind to the
+// functions we use when they are used for the first time, so the
+// application doesn't depend on xcb (or its extensions) at link time.
+FLH_GENERATE_SYMBOL(xcb, 1, xcb_change_property)
+FLH_GENERATE_SYMBOL(xcb, 1, xcb_flush)
+FLH_GENERATE_SYMBOL(xcb, 1, xcb_get_property)
+FLH_GENERATE_SYMBOL(xcb, 1, xcb_get_property_reply)
+FLH_GENERATE_SYMBOL(xcb, 1, xcb_get_property_value)
+FLH_GENERATE_SYMBOL(xcb, 1, xcb_get_property_value_length)
+FLH_GENERATE_SYMBOL(xcb, 1, xcb_intern_atom)
+FLH_GENERATE_SYMBOL(xcb, 1, xcb_intern_atom_reply)
+FLH_GENERATE_SYMBOL(xcb, 1, xcb_query_extension)
+FLH_GENERATE_SYMBOL(xcb, 1, xcb_query_extension_reply)
+FLH_GENERATE_SYMBOL(xcb, 1, xcb_send_event)
+FLH_GENERATE_SYMBOL(xcb, 1, xcb_ungrab_pointer)
+#ifdef FLH_HAVE_XCB_SHAPE
+FLH_GENERATE_SYMBOL(xcb-shape, 0, xcb_shape_mask)
+FLH_GENERATE_SYMBOL(xcb-shape, 0, xcb_shape_rectangles)
+#endif
+
+// _NET_WM_MOVERESIZE directions, see the Extended Window Manager Hints.
+enum : quint32 {
+    NET_WM_MOVERESIZE_SIZE_TOPLEFT = 0,
+    NET_WM_MOVERESIZE_SIZE_TOP = 1,
+    NET_WM_MOVERESIZE_SIZE_TOPRIGHT = 2,
+    NET_WM_MOVERESIZE_SIZE_RIGHT = 3,
+    NET_WM_MOVERESIZE_SIZE_BOTTOMRIGHT = 4,
+    NET_WM_MOVERESIZE_SIZE_BOTTOM = 5,
+    NET_WM_MOVERESIZE_SIZE_BOTTOMLEFT = 6,
+    NET_WM_MOVERESIZE_SIZE_LEFT = 7,
+    NET_WM_MOVERESIZE_MOVE = 8
+};
+
+xcb_connection_t *getConnection() {
+    if (QGuiApplication::platformName() != QStringLiteral("xcb")) {
+        return nullptr;
+    }
+    QPlatformNativeInterface *const nativeInterface =
+        QGuiApplication::platformNativeInterface();
+    if (!nativeInterface) {
+        return nullptr;
+    }
+    return static_cast<xcb_connection_t *>(
+        nativeInterface->nativeResourceForIntegration(
+            QByteArrayLiteral("connection")));
+}
+
+xcb_window_t getRootWindow() {
+    QPlatformNativeInterface *const nativeInterface =
+        QGuiApplication::platformNativeInterface();
+    if (!nativeInterface) {
+        return XCB_NONE;
+    }
+    return static_cast<xcb_window_t>(reinterpret_cast<quintptr>(
+        nativeInterface->nativeResourceForIntegration(
+            QByteArrayLiteral("rootwindow"))));
+}
+
+// Atoms never change during the life time of the connection. Failures are
+// not cached, the next call asks the X server again.
+QHash<QByteArray, xcb_atom_t> m_atoms;
+
+xcb_atom_t getAtom(xcb_connection_t *const connection, const QByteArray &name) {
+    const auto it = m_atoms.constFind(name);
+    if (it != m_atoms.constEnd()) {
+        return *it;
+    }
+    xcb_atom_t atom = XCB_NONE;
+    xcb_intern_atom_reply_t *const reply = m_lpxcb_intern_atom_reply(
+        connection,
+        m_lpxcb_intern_atom(connection, false, name.size(), name.constData()),
+        nullptr);
+    if (reply) {
+        atom = reply->atom;
+        free(reply);
+    }
+    if (atom != XCB_NONE) {
+        m_atoms.insert(name, atom);
+    }
+    return atom;
+}
+
+// -1: not queried yet, or the window manager has changed since.
+int m_moveResizeSupported = -1;
+
+// A new window manager sets _NET_SUPPORTING_WM_CHECK and _NET_SUPPORTED of
+// the root window, ask it again then. Qt listens to the property changes of
+// the root window already.
+class WindowManagerListener : public QAbstractNativeEventFilter {
+public:
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    bool nativeEventFilter(const QByteArray &eventType, void *message,
+                           qintptr *result) override
+#else
+    bool nativeEventFilter(const QByteArray &eventType, void *message,
+                           long *result) override
+#endif
+    {
+        Q_UNUSED(result)
+        if (!message ||
+            (eventType != QByteArrayLiteral("xcb_generic_event_t"))) {
+            return false;
+        }
+        const auto event = static_cast<xcb_generic_event_t *>(message);
+        if ((event->response_type & ~0x80) != XCB_PROPERTY_NOTIFY) {
+            return false;
+        }
+        const auto notify = static_cast<xcb_property_notify_event_t *>(message);
+        xcb_connection_t *const connection = getConnection();
+        if (connection && (notify->window == getRootWindow()) &&
+            ((notify->atom ==
+              getAtom(connection, QByteArrayLiteral("_NET_SUPPORTED"))) ||
+             (notify->atom ==
+              getAtom(connection,
+                      QByteArrayLiteral("_NET_SUPPORTING_WM_CHECK"))))) {
+            m_moveResizeSupported = -1;
+        }
+        return false;
+    }
+};
+
+bool m_windowManagerWatched = false;
+
+void watchWindowManager() {
+    if (m_windowManagerWatched) {
+        return;
+    }
+    m_windowManagerWatched = true;
+    const auto listener = new WindowManagerListener;
+    qApp->installNativeEventFilter(listener);
+    QObject::connect(qApp, &QObject::destroyed, [listener]() {
+        delete listener;
+        m_windowManagerWatched = false;
+        m_moveResizeSupported = -1;
+    });
+}
+
+bool isMoveResizeSupported(xcb_connection_t *const connection) {
+    watchWindowManager();
+    if (m_moveResizeSupported >= 0) {
+        return m_moveResizeSupported > 0;
+    }
+    m_moveResizeSupported = 0;
+    const xcb_atom_t supported =
+        getAtom(connection, QByteArrayLiteral("_NET_SUPPORTED"));
+    const xcb_atom_t moveResize =
+        getAtom(connection, QByteArrayLiteral("_NET_WM_MOVERESIZE"));
+    if ((supported == XCB_NONE) || (moveResize == XCB_NONE)) {
+        return false;
+    }
+    xcb_get_property_reply_t *const reply = m_lpxcb_get_property_reply(
+        connection,
+        m_lpxcb_get_property(connection, false, getRootWindow(), supported,
+                             XCB_ATOM_ATOM, 0, 4096),
+        nullptr);
+    if (reply) {
+        const auto atoms = static_cast<const xcb_atom_t *>(
+            m_lpxcb_get_property_value(reply));
+        const int count =
+            m_lpxcb_get_property_value_length(reply) / sizeof(xcb_atom_t);
+        for (int i = 0; i != count; ++i) {
+            if (atoms[i] == moveResize) {
+                m_moveResizeSupported = 1;
+                break;
+            }
+        }
+        free(reply);
+    }
+    return m_moveResizeSupported > 0;
+}
+
+// _MOTIF_WM_HINTS, see MwmUtil.h of Motif.
+enum : quint32 {
+    MWM_HINTS_FUNCTIONS = 1 << 0,
+    MWM_HINTS_DECORATIONS = 1 << 1,
+    MWM_FUNC_ALL = 1 << 0,
+    MWM_DECOR_BORDER = 1 << 1,
+    MWM_DECOR_RESIZEH = 1 << 2
+};
+
+using MOTIFWMHINTS = struct _MOTIFWMHINTS {
+    quint32 flags = 0, functions = 0, decorations = 0;
+    qint32 inputMode = 0;
+    quint32 status = 0;
+};
+
+quint32 getDirection(const Qt::Edges edges) {
+    if (edges == Qt::Edges{}) {
+        return NET_WM_MOVERESIZE_MOVE;
+    }
+    if (edges.testFlag(Qt::TopEdge)) {
+        if (edges.testFlag(Qt::LeftEdge)) {
+            return NET_WM_MOVERESIZE_SIZE_TOPLEFT;
+        }
+        if (edges.testFlag(Qt::RightEdge)) {
+            return NET_WM_MOVERESIZE_SIZE_TOPRIGHT;
+        }
+        return NET_WM_MOVERESIZE_SIZE_TOP;
+    }
+    if (edges.testFlag(Qt::BottomEdge)) {
+        if (edges.testFlag(Qt::LeftEdge)) {
+            return NET_WM_MOVERESIZE_SIZE_BOTTOMLEFT;
+        }
+        if (edges.testFlag(Qt::RightEdge)) {
+            return NET_WM_MOVERESIZE_SIZE_BOTTOMRIGHT;
+        }
+        return NET_WM_MOVERESIZE_SIZE_BOTTOM;
+    }
+    return edges.testFlag(Qt::LeftEdge) ? NET_WM_MOVERESIZE_SIZE_LEFT
+                                        : NET_WM_MOVERESIZE_SIZE_RIGHT;
+}
+
+#ifdef FLH_HAVE_XCB_XINPUT
+// -1: not queried yet, 0: no XInput extension.
+int m_xiOpcode = -1;
+
+int getXInputOpcode(xcb_connection_t *const connection) {
+    if (m_xiOpcode >= 0) {
+        return m_xiOpcode;
+    }
+    m_xiOpcode = 0;
+    const QByteArray name = QByteArrayLiteral("XInputExtension");
+    xcb_query_extension_reply_t *const reply = m_lpxcb_query_extension_reply(
+        connection,
+        m_lpxcb_query_extension(connection, name.size(), name.constData()),
+        nullptr);
+    if (reply) {
+        if (reply->present) {
+            m_xiOpcode = reply->major_opcode;
+        }
+        free(reply);
+    }
+    return m_xiOpcode;
+}
+
+qreal fp1616ToReal(const xcb_input_fp1616_t val) {
+    return static_cast<qreal>(val) / 65536.0;
+}
+#endif
+
+} // namespace
+
+#endif
+
+X11NativeEventFilter::X11NativeEventFilter(FramelessHelper *const helper)
+    : m_helper(helper) {}
+
+bool X11NativeEventFilter::isPlatformX11() {
+#ifdef FLH_HAVE_XCB
+    return getConnection() != nullptr;
+#else
+    return false;
+#endif
+}
+
+bool X11NativeEventFilter::isAvailable() {
+#ifdef FLH_HAVE_XCB
+    xcb_connection_t *const connection = getConnection();
+    return connection && isMoveResizeSupported(connection);
+#else
+    return false;
+#endif
+}
+
+bool X11NativeEventFilter::startSystemMoveResize(QWindow *const window,
+                                                 const QPoint &globalPos,
+                                                 const Qt::Edges edges) {
+#ifdef FLH_HAVE_XCB
+    if (!window || !window->handle()) {
+        return false;
+    }
+    xcb_connection_t *const connection = getConnection();
+    if (!connection || !isMoveResizeSupported(connection)) {
+        return false;
+    }
+    // The window manager can't grab the pointer while we (Qt's implicit
+    // grab of the button press) are holding it.
+    m_lpxcb_ungrab_pointer(connection, XCB_CURRENT_TIME);
+    // Root window coordinates. The scale factor and the origin of the screen
+    // matter, not just the device pixel ratio: with several screens (or
+    // several DPIs) the logical and the native desktop are laid out
+    // differently.
+    const QPoint nativePos =
+        QHighDpi::toNativePixels(globalPos, window->screen());
+    xcb_client_message_event_t message = {};
+    message.response_type = XCB_CLIENT_MESSAGE;
+    message.format = 32;
+    message.window = static_cast<xcb_window_t>(window->winId());
+    message.type =
+        getAtom(connection, QByteArrayLiteral("_NET_WM_MOVERESIZE"));
+    message.data.data32[0] = nativePos.x();
+    message.data.data32[1] = nativePos.y();
+    message.data.data32[2] = getDirection(edges);
+    message.data.data32[3] = XCB_BUTTON_INDEX_1;
+    // Source indication: normal application.
+    message.data.data32[4] = 1;
+    m_lpxcb_send_event(connection, false, getRootWindow(),
+                       XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT |
+                           XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY,
+                       reinterpret_cast<const char *>(&message));
+    m_lpxcb_flush(connection);
+    // The window manager owns the pointer from now on and we will never
+    // get the button release, tell Qt it has been released so it doesn't
+    // think the button is still down after the move/resize.
+    // The positions are native ones, like the ones of the platform plugin.
+    QWindowSystemInterface::handleMouseEvent(
+        window,
+        QHighDpi::toNativeLocalPosition(window->mapFromGlobal(globalPos),
+                                        window),
+        nativePos, Qt::NoButton, Qt::LeftButton, QEvent::MouseButtonRelease);
+    return true;
+#else
+    Q_UNUSED(window)
+    Q_UNUSED(globalPos)
+    Q_UNUSED(edges)
+    return false;
+#endif
+}
+
+bool X11NativeEventFilter::setBordersOnly(QWindow *const window) {
+#ifdef FLH_HAVE_XCB
+    if (!window || !window->handle()) {
+        return false;
+    }
+    xcb_connection_t *const connection = getConnection();
+    if (!connection) {
+        return false;
+    }
+    const xcb_atom_t atom =
+        getAtom(connection, QByteArrayLiteral("_MOTIF_WM_HINTS"));
+    if (atom == XCB_NONE) {
+        return false;
+    }
+    MOTIFWMHINTS hints;
+    hints.flags = MWM_HINTS_FUNCTIONS | MWM_HINTS_DECORATIONS;
+    hints.functions = MWM_FUNC_ALL;
+    hints.decorations = MWM_DECOR_BORDER | MWM_DECOR_RESIZEH;
+    m_lpxcb_change_property(connection, XCB_PROP_MODE_REPLACE,
+                            static_cast<xcb_window_t>(window->winId()), atom,
+                            atom, 32, 5, &hints);
+    m_lpxcb_flush(connection);
+    return true;
+#else
+    Q_UNUSED(window)
+    return false;
+#endif
+}
+
+bool X11NativeEventFilter::setInputShape(QWindow *const window,
+                                         const QRegion &region) {
+#if defined(FLH_HAVE_XCB) && defined(FLH_HAVE_XCB_SHAPE)
+    if (!window || !window->handle()) {
+        return false;
+    }
+    xcb_connection_t *const connection = getConnection();
+    if (!connection || !m_lpxcb_shape_mask.isAvailable() ||
+        !m_lpxcb_shape_rectangles.isAvailable()) {
+        return false;
+    }
+    const auto windowId = static_cast<xcb_window_t>(window->winId());
+    if (region == QRegion(QRect({0, 0}, window->size()))) {
+        // Reset to the bounding shape, which is the whole window.
+        m_lpxcb_shape_mask(connection, XCB_SHAPE_SO_SET, XCB_SHAPE_SK_INPUT,
+                           windowId, 0, 0, XCB_NONE);
+    } else {
+        const qreal dpr = window->devicePixelRatio();
+        QVector<xcb_rectangle_t> rects = {};
+        rects.reserve(region.rectCount());
+        for (auto &&rect : region) {
+            const QRect nativeRect = {(rect.topLeft() * dpr),
+                                      (rect.size() * dpr)};
+            rects.append({static_cast<int16_t>(nativeRect.x()),
+                          static_cast<int16_t>(nativeRect.y()),
+                          static_cast<uint16_t>(nativeRect.width()),
+                          static_cast<uint16_t>(nativeRect.height())});
+        }
+        m_lpxcb_shape_rectangles(connection, XCB_SHAPE_SO_SET,
+                                 XCB_SHAPE_SK_INPUT,
+                                 XCB_CLIP_ORDERING_YX_BANDED, windowId, 0, 0,
+                                 rects.size(), rects.constData());
+    }
+    m_lpxcb_flush(connection);
+    return true;
+#else
+    Q_UNUSED(window)
+    Q_UNUSED(region)
+    return false;
+#endif
+}
+
+QByteArray X11NativeEventFilter::getXResource(const QByteArray &name) {
+#ifdef FLH_HAVE_XCB
+    if (name.isEmpty()) {
+        return {};
+    }
+    xcb_connection_t *const connection = getConnection();
+    if (!connection) {
+        return {};
+    }
+    xcb_get_property_reply_t *const reply = m_lpxcb_get_property_reply(
+        connection,
+        m_lpxcb_get_property(connection, false, getRootWindow(),
+                             XCB_ATOM_RESOURCE_MANAGER, XCB_ATOM_STRING, 0,
+                             16384),
+        nullptr);
+    if (!reply) {
+        return {};
+    }
+    const QByteArray database(
+        static_cast<const char *>(m_lpxcb_get_property_value(reply)),
+        m_lpxcb_get_property_value_length(reply));
+    free(reply);
+    // One "name:\tvalue" pair per line, as written by xrdb.
+    const QByteArray prefix = name + ':';
+    for (auto &&line : database.split('\n')) {
+        if (line.startsWith(prefix)) {
+            return line.mid(prefix.size()).trimmed();
+        }
+    }
+    return {};
+#else
+    Q_UNUSED(name)
+    return {};
+#endif
+}
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+bool X11NativeEventFilter::nativeEventFilter(const QByteArray &eventType,
+                                             void *message, qintptr *result)
+#else
+bool X11NativeEventFilter::nativeEventFilter(const QByteArray &eventType,
+                                             void *message, long *result)
+#endif
+{
+    Q_UNUSED(result)
+#ifdef FLH_HAVE_XCB
+    if (!m_helper || !message ||
+        (eventType != QByteArrayLiteral("xcb_generic_event_t"))) {
+        return false;
+    }
+    const auto event = static_cast<xcb_generic_event_t *>(message);
+    switch (event->response_type & ~0x80) {
+    case XCB_BUTTON_PRESS: {
+        const auto press = static_cast<xcb_button_press_event_t *>(message);
+        if (press->detail == XCB_BUTTON_INDEX_1) {
+            return handleButtonPress(press->event,
+                                     {static_cast<qreal>(press->event_x),
+                                      static_cast<qreal>(press->event_y)},
+                                     press->time);
+        }
+    } break;
+    case XCB_MOTION_NOTIFY: {
+        const auto motion = static_cast<xcb_motion_notify_event_t *>(message);
+        handleMotion(motion->event, {static_cast<qreal>(motion->event_x),
+                                     static_cast<qreal>(motion->event_y)});
+    } break;
+#ifdef FLH_HAVE_XCB_XINPUT
+    case XCB_GE_GENERIC: {
+        // Qt selects XI2 pointer events if the server supports them, the
+        // core events above are not sent at all in that case.
+        const auto xiEvent =
+            static_cast<xcb_input_button_press_event_t *>(message);
+        xcb_connection_t *const connection = getConnection();
+        if (!connection || (xiEvent->extension == 0) ||
+            (xiEvent->extension != getXInputOpcode(connection))) {
+            break;
+        }
+        const QPointF pos = {fp1616ToReal(xiEvent->event_x),
+                             fp1616ToReal(xiEvent->event_y)};
+        if (xiEvent->event_type == XCB_INPUT_BUTTON_PRESS) {
+            // Presses emulated from touch events are handled by the touch
+            // gesture code of FramelessHelper.
+            if ((xiEvent->detail == XCB_BUTTON_INDEX_1) &&
+                !(xiEvent->flags &
+                  XCB_INPUT_POINTER_EVENT_FLAGS_POINTER_EMULATED)) {
+                return handleButtonPress(xiEvent->event, pos, xiEvent->time);
+            }
+        } else if (xiEvent->event_type == XCB_INPUT_MOTION) {
+            handleMotion(xiEvent->event, pos);
+        }
+    } break;
+#endif
+    default:
+        break;
+    }
+#else
+    Q_UNUSED(eventType)
+    Q_UNUSED(message)
+#endif
+    return false;
+}
+
+bool X11NativeEventFilter::handleButtonPress(const quint32 windowId,
+                                             const QPointF &nativePos,
+                                             const quint32 timestamp) {
+    QWindow *window = nullptr;
+    QObject *const obj = m_helper->getFramelessObject(windowId, &window);
+    if (!obj || !window) {
+        return false;
+    }
+    const QPointF pos = QHighDpi::fromNativeLocalPosition(nativePos, window);
+    const QPointF globalPos = window->mapToGlobal(pos.toPoint());
+    const bool doubleClick = (obj == m_lastPressObject) &&
+        ((timestamp - m_lastPressTime) <= static_cast<quint32>(
+             QGuiApplication::styleHints()->mouseDoubleClickInterval())) &&
+        ((globalPos - m_lastPressPos).manhattanLength() <=
+         QGuiApplication::styleHints()->startDragDistance());
+    m_lastPressObject = obj;
+    m_lastPressTime = timestamp;
+    m_lastPressPos = globalPos;
+    if (doubleClick && m_helper->isInTitlebarArea(globalPos, pos, obj)) {
+        m_lastPressObject = nullptr;
+        m_helper->toggleMaximized(obj);
+        return true;
+    }
+    // Presses emulated from touch events never get here, see above.
+    return m_helper->moveOrResize(globalPos, pos, obj, true);
+}
+
+void X11NativeEventFilter::handleMotion(const quint32 windowId,
+                                        const QPointF &nativePos) {
+    QWindow *window = nullptr;
+    QObject *const obj = m_helper->getFramelessObject(windowId, &window);
+    if (!obj || !window || m_helper->m_manualGrabs.value(obj).active) {
+        return;
+    }
+    // Coalesced with the other mouse moves, the cursor is updated once per
+    // pass of the event loop.
+    const QPointF pos = QHighDpi::fromNativeLocalPosition(nativePos, window);
+    m_helper->queueMouseMove(obj, pos, window->mapToGlobal(pos.toPoint()));
+}
+
+X11ResourceListener::X11ResourceListener(const std::function<void()> &callback)
+    : m_callback(callback) {}
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+bool X11ResourceListener::nativeEventFilter(const QByteArray &eventType,
+                                            void *message, qintptr *result)
+#else
+bool X11ResourceListener::nativeEventFilter(const QByteArray &eventType,
+                                            void *message, long *result)
+#endif
+{
+    Q_UNUSED(result)
+#ifdef FLH_HAVE_XCB
+    if (!m_callback || !message ||
+        (eventType != QByteArrayLiteral("xcb_generic_event_t"))) {
+        return false;
+    }
+    const auto event = static_cast<xcb_generic_event_t *>(message);
+    if ((event->response_type & ~0x80) == XCB_PROPERTY_NOTIFY) {
+        // The X resources change when the DPI or the cursor size of the
+        // desktop is changed.
+        const auto notify = static_cast<xcb_property_notify_event_t *>(message);
+        if ((notify->window == getRootWindow()) &&
+            (notify->atom == XCB_ATOM_RESOURCE_MANAGER)) {
+            m_callback();
+        }
+    }
+#else
+    Q_UNUSED(eventType)
+    Q_UNUSED(message)
+#endif
+    return false;
+}
@@ -0,0 +1,137 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2020 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <QAbstractNativeEventFilter>
+#include <QByteArray>
+#include <QPoint>
+#include <QPointF>
+#include <QRegion>
+#include <QtGlobal>
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+QT_FORWARD_DECLARE_CLASS(QObject)
+QT_FORWARD_DECLARE_CLASS(QWindow)
+QT_END_NAMESPACE
+
+class FramelessHelper;
+
+// Native X11 backend of FramelessHelper. Everything in it talks to the X
+// server through the xcb connection of Qt directly, it's only compiled in
+// if xcb is found by qmake (FLH_HAVE_XCB). All functions fail gracefully
+// (return false) on other platforms, such as Wayland, so the caller can fall
+// back to the Qt API.
+//
+// As a native event filter (see FramelessHelper::setNativeEventFilterEnabled)
+// it does the hit-testing of the frameless windows on the raw core and XI2
+// button press and motion events, before Qt translates them into
+// QMouseEvents and delivers them to the child widgets or items, just like
+// WinNativeEventFilter does with WM_NCHITTEST on Windows.
+class X11NativeEventFilter : public QAbstractNativeEventFilter {
+    Q_DISABLE_COPY_MOVE(X11NativeEventFilter)
+
+public:
+    explicit X11NativeEventFilter(FramelessHelper *const helper);
+    ~X11NativeEventFilter() override = default;
+
+    // True if the application is running on X11 (through xcb).
+    static bool isPlatformX11();
+
+    // True if the application is running on X11 and the window manager
+    // supports _NET_WM_MOVERESIZE.
+    static bool isAvailable();
+
+    // Let the window manager move (empty edges) or resize the window, by
+    // sending the _NET_WM_MOVERESIZE client message ourselves. The global
+    // position is the position of the pointer in device independent pixels.
+    // It must be called while the left mouse button is down, and not for
+    // touch presses: the window manager is told that button 1 is down and
+    // Qt is sent a fake button release.
+    static bool startSystemMoveResize(QWindow *const window,
+                                      const QPoint &globalPos,
+                                      const Qt::Edges edges);
+
+    // Ask the window manager to draw only the border of the window (which
+    // can be used to resize it), without the title bar and it's buttons.
+    static bool setBordersOnly(QWindow *const window);
+
+    // Set the input shape of the window, the region is in device
+    // independent pixels. An empty region makes the whole window
+    // click-through, a region covering the whole window resets the shape.
+    static bool setInputShape(QWindow *const window, const QRegion &region);
+
+    // A value of the X resource database of the desktop (RESOURCE_MANAGER),
+    // such as "Xft.dpi" or "Xcursor.size", empty if it isn't set. It's read
+    // from the X server on every call, cache the result.
+    static QByteArray getXResource(const QByteArray &name);
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    bool nativeEventFilter(const QByteArray &eventType, void *message,
+                           qintptr *result) override;
+#else
+    bool nativeEventFilter(const QByteArray &eventType, void *message,
+                           long *result) override;
+#endif
+
+private:
+    // The positions are relative to the window, in native pixels. Return
+    // true if the event has been handled and must not reach Qt.
+    bool handleButtonPress(const quint32 windowId, const QPointF &nativePos,
+                           const quint32 timestamp);
+    void handleMotion(const quint32 windowId, const QPointF &nativePos);
+
+    FramelessHelper *m_helper = nullptr;
+    // For the double clicks on the title bar, Qt never sees the presses we
+    // handled.
+    QObject *m_lastPressObject = nullptr;
+    quint32 m_lastPressTime = 0;
+    QPointF m_lastPressPos = {};
+};
+
+// Calls the callback when the X resource database of the desktop
+// (RESOURCE_MANAGER of the root window) changes, such as "Xft.dpi" or
+// "Xcursor.size". Qt listens to the property changes of the root window
+// already, it's enough to install it as a native event filter of the
+// application. It does nothing on other platforms.
+class X11ResourceListener : public QAbstractNativeEventFilter {
+    Q_DISABLE_COPY_MOVE(X11ResourceListener)
+
+public:
+    explicit X11ResourceListener(const std::function<void()> &callback);
+    ~X11ResourceListener() override = default;
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    bool nativeEventFilter(const QByteArray &eventType, void *message,
+                           qintptr *result) override;
+#else
+    bool nativeEventFilter(const QByteArray &eventType, void *message,
+                           long *result) override;
+#endif
+
+private:
+    std::function<void()> m_callback = nullptr;
+};